@@ -32,6 +32,10 @@
 
 #include <cmath>
 
+constexpr int g_fusedBlockFrames = 1024; // Must be even, "Echo" surround depends on the sample index parity
+constexpr double g_coalesceDuration = 0.02; // Same as the output chunk length
+constexpr double g_coalesceMaxGap = 0.002;
+
 AudioThr::AudioThr(PlayClass &playC, const QStringList &pluginsName) :
     AVThread(playC)
 {
@@ -180,6 +184,7 @@ void AudioThr::run()
     {
         double delay = 0.0, audio_pts = 0.0; //"audio_pts" odporny na zerowanie przy przewijaniu
         Decoder *last_dec = dec;
+        const bool rawAudio = dec && dec->name().isEmpty(); // Not encoded, packets are samples
         while (!br && dec == last_dec)
         {
             playC.aPackets.lock();
@@ -237,7 +242,11 @@ void AudioThr::run()
 
             Packet packet;
             if (!hasBufferedSamples && (dec->pendingFrames() == 0 || flushAudio))
+            {
                 packet = playC.aPackets.fetch();
+                if (rawAudio && !flushAudio && playC.audioSeekPos <= 0.0)
+                    coalescePackets(packet);
+            }
             else if (hasBufferedSamples)
                 ts = audio_pts + playC.audio_last_delay + delay; //szacowanie czasu
             playC.aPackets.unlock();
@@ -290,12 +299,12 @@ void AudioThr::run()
             }
 
             delay = writer->getParam("delay").toDouble() + sndResampler.getDelay();
-            for (AudioFilter *filter : std::as_const(filters))
+            if (flushAudio)
             {
-                if (flushAudio)
+                for (AudioFilter *filter : std::as_const(filters))
                     filter->clearBuffers();
-                delay += filter->filter(decoded, hasBufferedSamples);
             }
+            delay += filterAudio(decoded, hasBufferedSamples);
 
             if (flushAudio)
                 playC.flushAudio = false;
@@ -423,6 +432,8 @@ void AudioThr::run()
                     do
                     {
                         const int ret = writer->write(dataToWrite);
+                        if (ret >= 0)
+                            playC.stopTransitionTimer();
                         if (ret >= 0 || !writer->readyWrite())
                             break;
                     } while (!br && !br2);
@@ -458,6 +469,85 @@ bool AudioThr::createResampler(bool cleanBuffers)
     return true;
 }
 
+void AudioThr::coalescePackets(Packet &packet)
+{
+    // Join the following contiguous packets, so small packets are processed in larger blocks
+    if (packet.isEmpty() || packet.duration() <= 0.0 || packet.duration() >= g_coalesceDuration)
+        return;
+
+    std::vector<Packet> &packets = m_coalescedPackets;
+    packets.clear();
+    double duration = packet.duration();
+    int size = packet.size();
+    double nextTs = packet.ts() + duration;
+    while (duration < g_coalesceDuration && playC.aPackets.canFetch())
+    {
+        if (qAbs(playC.aPackets.currentPacketTime() - nextTs) > g_coalesceMaxGap)
+            break;
+        Packet next = playC.aPackets.fetch();
+        const double nextDuration = next.duration();
+        duration += nextDuration;
+        size += next.size();
+        nextTs = next.ts() + nextDuration;
+        packets.push_back(std::move(next));
+        if (nextDuration <= 0.0)
+            break; // Can't predict the next timestamp
+    }
+    if (packets.empty())
+        return;
+
+    // The buffer is reallocated in place when the previous block is no longer referenced
+    Packet &block = m_coalescedBlock;
+    block.setTimeBase(packet.timeBase());
+    block.resize(size);
+    block.setTS(packet.ts());
+    block.setDuration(duration);
+
+    quint8 *data = block.data();
+    memcpy(data, packet.data(), packet.size());
+    data += packet.size();
+    for (const Packet &next : packets)
+    {
+        memcpy(data, next.data(), next.size());
+        data += next.size();
+    }
+    packets.clear();
+
+    packet = block;
+}
+
+double AudioThr::filterAudio(QByteArray &data, bool flush)
+{
+    double delay = 0.0;
+    const int nFilters = filters.size();
+    for (int i = 0; i < nFilters;)
+    {
+        int end = i;
+        while (end < nFilters && filters[end]->canBeFused())
+            ++end;
+
+        if (end - i < 2)
+        {
+            delay += filters[i]->filter(data, flush);
+            ++i;
+            continue;
+        }
+
+        // Run consecutive per-frame filters block by block, so the data stays in cache between them
+        const int size = data.size() / sizeof(float);
+        const int blockSize = g_fusedBlockFrames * currentChannels();
+        float *samples = (size > 0) ? (float *)data.data() : nullptr;
+        for (int pos = 0; pos < size; pos += blockSize)
+        {
+            const int blockLen = qMin(blockSize, size - pos);
+            for (int f = i; f < end; ++f)
+                filters[f]->filterSamples(samples + pos, blockLen);
+        }
+        i = end;
+    }
+    return delay;
+}
+
 inline uchar AudioThr::currentChannels() const
 {
     return m_resamplerFirst ? channels : realChannels;
@@ -21,9 +21,12 @@
 #include <AVThread.hpp>
 
 #include <SndResampler.hpp>
+#include <Packet.hpp>
 
 #include <QVector>
 
+#include <vector>
+
 class QMPlay2Extensions;
 class PlayClass;
 class AudioFilter;
@@ -51,6 +54,9 @@ private:
 
     bool createResampler(bool cleanBuffers);
 
+    void coalescePackets(Packet &packet);
+    double filterAudio(QByteArray &data, bool flush);
+
     inline uchar currentChannels() const;
     inline uint currentSampleRate() const;
 
@@ -69,6 +75,10 @@ private:
 
     QVector<QMPlay2Extensions *> visualizations;
     QVector<AudioFilter *> filters;
+
+    // Reused by "coalescePackets()"
+    std::vector<Packet> m_coalescedPackets;
+    Packet m_coalescedBlock;
 private slots:
     void pauseVis(bool);
 signals:
@@ -0,0 +1,195 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <DecodeAheadThr.hpp>
+
+#include <PlayClass.hpp>
+#include <VideoThr.hpp>
+#include <Decoder.hpp>
+
+DecodeAheadThr::DecodeAheadThr(VideoThr &vThr, PlayClass &playC, int maxFrames, qint64 maxBytes)
+    : m_vThr(vThr)
+    , playC(playC)
+    , m_maxFrames(maxFrames)
+    , m_maxBytes(maxBytes)
+{
+    setObjectName("DecodeAheadThr");
+    start();
+}
+DecodeAheadThr::~DecodeAheadThr()
+{
+    m_br = true;
+    m_queueCond.wakeAll();
+    wait();
+}
+
+void DecodeAheadThr::setLocked(bool locked)
+{
+    m_locked = locked;
+    if (locked)
+    {
+        // Wait for the frame which is being decoded right now
+        m_decodeMutex.lock();
+        m_decodeMutex.unlock();
+    }
+    else
+    {
+        m_queueCond.wakeAll();
+    }
+}
+void DecodeAheadThr::setSyncDecoding(bool syncDecoding)
+{
+    if (m_syncDecoding == syncDecoding)
+        return;
+    m_syncDecoding = syncDecoding;
+    if (syncDecoding)
+    {
+        m_decodeMutex.lock();
+        m_decodeMutex.unlock();
+    }
+    else
+    {
+        m_queueCond.wakeAll();
+    }
+}
+
+bool DecodeAheadThr::hasFrames()
+{
+    QMutexLocker locker(&m_queueMutex);
+    return !m_queue.empty();
+}
+bool DecodeAheadThr::take(Decoded &decoded)
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (m_queue.empty())
+        return false;
+    decoded = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_queueBytes -= decoded.frameBytes;
+    m_queueCond.wakeAll();
+    return true;
+}
+void DecodeAheadThr::waitForFrame(int ms)
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (m_queue.empty())
+        m_queueCond.wait(&m_queueMutex, ms);
+}
+
+void DecodeAheadThr::clear()
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_queue.clear();
+    m_queueBytes = 0;
+    m_pendingBytesConsumed = 0;
+    m_queueCond.wakeAll();
+}
+
+void DecodeAheadThr::run()
+{
+    while (!m_br)
+    {
+        QMutexLocker decodeLocker(&m_decodeMutex);
+        if (!canDecode())
+        {
+            decodeLocker.unlock();
+            waitForDecoder();
+            continue;
+        }
+
+        // "DemuxerThr" locks the video thread while holding the packet buffer lock when seeking,
+        // so never block here indefinitely - it would wait for the decode mutex forever.
+        bool vPacketsLocked = false;
+        while (!(vPacketsLocked = playC.vPackets.tryLock(2)) && canDecode());
+        if (!vPacketsLocked)
+            continue;
+
+        if (!playC.vPackets.canFetch())
+        {
+            playC.vPackets.unlock();
+            decodeLocker.unlock();
+            playC.fillBufferB = true;
+            waitForDecoder();
+            continue;
+        }
+        const Packet packet = playC.vPackets.fetch();
+        playC.vPackets.unlock();
+        playC.fillBufferB = true;
+
+        Decoded decoded;
+        decoded.bytesConsumed = m_vThr.dec->decodeVideo(packet, decoded.frame, decoded.newPixelFormat, false, 0);
+
+        // Push before releasing the decode mutex, so "setLocked()" and "setSyncDecoding()" return
+        // after the frame is queued and "clear()" drops it - otherwise it could arrive out of order.
+        push(std::move(decoded));
+        decodeLocker.unlock();
+
+        playC.emptyBufferCond.wakeAll();
+    }
+}
+
+void DecodeAheadThr::setSupportedPixelFormats(const AVPixelFormats &pixelFormats)
+{
+    // Don't change the output format while a frame is being decoded
+    QMutexLocker decodeLocker(&m_decodeMutex);
+    m_vThr.dec->setSupportedPixelFormats(pixelFormats);
+}
+
+bool DecodeAheadThr::canDecode()
+{
+    if (m_br || !m_enabled || m_locked || m_syncDecoding || !m_vThr.dec)
+        return false;
+    if (playC.flushVideo || playC.videoSeekPos > 0.0)
+        return false;
+
+    QMutexLocker locker(&m_queueMutex);
+    return (m_queue.size() < static_cast<size_t>(m_maxFrames) && m_queueBytes < m_maxBytes);
+}
+void DecodeAheadThr::waitForDecoder()
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (!m_br)
+        m_queueCond.wait(&m_queueMutex, 10);
+}
+
+void DecodeAheadThr::push(Decoded &&decoded)
+{
+    QMutexLocker locker(&m_queueMutex);
+
+    if (decoded.frame.isEmpty() && decoded.bytesConsumed >= 0 && decoded.newPixelFormat == AV_PIX_FMT_NONE)
+    {
+        m_pendingBytesConsumed += decoded.bytesConsumed;
+        return;
+    }
+    if (decoded.bytesConsumed >= 0)
+    {
+        decoded.bytesConsumed += m_pendingBytesConsumed;
+        m_pendingBytesConsumed = 0;
+    }
+
+    if (decoded.frame.hasCPUAccess())
+    {
+        const int numPlanes = decoded.frame.numPlanes();
+        for (int p = 0; p < numPlanes; ++p)
+            decoded.frameBytes += static_cast<qint64>(decoded.frame.linesize(p)) * decoded.frame.height(p);
+    }
+
+    m_queueBytes += decoded.frameBytes;
+    m_queue.push_back(std::move(decoded));
+    m_queueCond.wakeAll();
+}
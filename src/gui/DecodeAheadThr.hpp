@@ -0,0 +1,95 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Frame.hpp>
+
+#include <QWaitCondition>
+#include <QThread>
+#include <QMutex>
+
+#include <atomic>
+#include <deque>
+
+class VideoThr;
+class PlayClass;
+
+/* Decodes software video frames ahead of presentation into a bounded queue */
+class DecodeAheadThr final : public QThread
+{
+public:
+    struct Decoded
+    {
+        Frame frame;
+        int bytesConsumed = 0;
+        AVPixelFormat newPixelFormat = AV_PIX_FMT_NONE;
+        qint64 frameBytes = 0;
+    };
+
+    DecodeAheadThr(VideoThr &vThr, PlayClass &playC, int maxFrames, qint64 maxBytes);
+    ~DecodeAheadThr();
+
+    inline void setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+    inline bool isEnabled() const
+    {
+        return m_enabled;
+    }
+
+    void setLocked(bool locked);
+    void setSyncDecoding(bool syncDecoding);
+
+    bool hasFrames();
+    bool take(Decoded &decoded);
+    void waitForFrame(int ms);
+
+    void clear();
+
+    void setSupportedPixelFormats(const AVPixelFormats &pixelFormats);
+
+private:
+    void run() override;
+
+    bool canDecode();
+    void waitForDecoder();
+
+    void push(Decoded &&decoded);
+
+private:
+    VideoThr &m_vThr;
+    PlayClass &playC;
+
+    const int m_maxFrames;
+    const qint64 m_maxBytes;
+
+    std::atomic_bool m_br {false};
+    std::atomic_bool m_enabled {false};
+    std::atomic_bool m_locked {true};
+    std::atomic_bool m_syncDecoding {false};
+
+    QMutex m_decodeMutex;
+
+    QMutex m_queueMutex;
+    QWaitCondition m_queueCond;
+    std::deque<Decoded> m_queue;
+    qint64 m_queueBytes = 0;
+    int m_pendingBytesConsumed = 0;
+};
@@ -298,6 +298,8 @@ void DemuxerThr::seek(bool doDemuxerSeek)
 
 void DemuxerThr::stop()
 {
+    if (m_prefetch)
+        m_prefetch->abort();
     ioCtrl.abort();
     demuxer.abort();
 }
@@ -379,7 +381,15 @@ void DemuxerThr::run()
         return;
     }
 
-    if (!Demuxer::create(url, demuxer) || demuxer.isAborted())
+    if (m_prefetch && m_prefetch->url() == url)
+    {
+        // Use the demuxer and packets opened in advance
+        m_prefetch->wait();
+        demuxer.swap(m_prefetch->demuxer);
+        m_prefetchedPackets.swap(m_prefetch->packets);
+    }
+
+    if ((!demuxer && !Demuxer::create(url, demuxer)) || demuxer.isAborted())
     {
         if (!demuxer.isAborted() && !demuxer)
         {
@@ -516,6 +526,7 @@ void DemuxerThr::run()
         backwardTime = qMax(0.1, m_minBuffTimeNetwork) * percent / 100.0;
     }
     PacketBuffer::setBackwardTime(backwardTime);
+    PacketBuffer::setSpillSize((forwardTime > 0.0) ? QMPlay2Core.getSettings().getInt("TimeshiftSize") * 1048576LL : 0);
 
     if (!localStream)
         setPriority(QThread::LowPriority); //Network streams should have low priority, because slow single core CPUs have problems with smooth video playing during buffering
@@ -581,6 +592,13 @@ void DemuxerThr::run()
             playC.pauseAfterFirstFrame = false;
         }
 
+        if (!m_prefetchNextRequested && !unknownLength && !playC.doRepeat && (playC.endOfStream || demuxer->length() - playC.pos <= 5.0))
+        {
+            m_prefetchNextRequested = true;
+            if (QMPlay2Core.getSettings().getBool("PrefetchNextEntry"))
+                emit playC.prefetchNext();
+        }
+
         const bool updateBuffered = localStream ? false : canUpdateBuffered();
         const double remainingDuration = getAVBuffersSize(vS, aS, vT, aT);
         if (playC.endOfStream && !vS && !aS && canBreak(aThr, vThr))
@@ -700,11 +718,23 @@ void DemuxerThr::run()
 
         Packet packet;
         int streamIdx = -1;
-        if (!localStream)
-            demuxerTimer.start(); //Start the timer which will update buffer and pause information while demuxer is busy for long time (demuxer must call "processEvents()" from time to time)
-        const bool demuxerOk = demuxer->read(packet, streamIdx);
-        if (!localStream)
-            demuxerTimer.stop(); //Stop the timer, because the demuxer loop updates the data automatically
+        bool demuxerOk;
+        if (!m_prefetchedPackets.empty())
+        {
+            auto &prefetched = m_prefetchedPackets.front();
+            streamIdx = prefetched.first;
+            packet = std::move(prefetched.second);
+            m_prefetchedPackets.pop_front();
+            demuxerOk = true;
+        }
+        else
+        {
+            if (!localStream)
+                demuxerTimer.start(); //Start the timer which will update buffer and pause information while demuxer is busy for long time (demuxer must call "processEvents()" from time to time)
+            demuxerOk = demuxer->read(packet, streamIdx);
+            if (!localStream)
+                demuxerTimer.stop(); //Stop the timer, because the demuxer loop updates the data automatically
+        }
         if (demuxerOk)
         {
             if (mustReloadStreams() && !load())
@@ -1045,6 +1075,9 @@ void DemuxerThr::emitInfo()
     if (demuxer->bitrate() > 0)
         info += "<b>" + tr("Bitrate") + ":</b> " + QString::number(demuxer->bitrate()) + "kbps<br/>";
     info += "<b>" + tr("Format") + ":</b> " + demuxer->name();
+    const double transitionTime = playC.transitionTime();
+    if (transitionTime >= 0.0)
+        info += "<br/><b>" + tr("Transition gap") + ":</b> " + QString::number(transitionTime, 'f', 1) + " ms";
 
     if (!demuxer->image().isNull())
         info += "<br/><br/><a href='save_cover'>" + tr("Save cover picture") + "</a>";
@@ -1425,6 +1458,7 @@ BufferInfo DemuxerThr::getBufferInfo(bool clearBackwards)
 }
 void DemuxerThr::clearBuffers()
 {
+    m_prefetchedPackets.clear();
     playC.vPackets.clear();
     playC.aPackets.clear();
     playC.clearSubtitlesBuffer();
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <IOController.hpp>
+#include <PrefetchThr.hpp>
 #include <StreamInfo.hpp>
 
 #include <QString>
@@ -111,6 +112,9 @@ private:
     double playIfBuffered, time, updateBufferedTime;
     std::unique_ptr<StreamMuxer> m_recMuxer;
     bool m_recording = false;
+    std::unique_ptr<PrefetchThr> m_prefetch;
+    PrefetchThr::PrefetchedPackets m_prefetchedPackets;
+    bool m_prefetchNextRequested = false;
 private slots:
     void stopVADec();
     void updateCover(const QString &title, const QString &artist, const QString &album, const QByteArray &cover);
@@ -60,6 +60,7 @@ void TextEdit::mousePressEvent(QMouseEvent *e)
 
 /**/
 
+#include <NetworkCache.hpp>
 #include <Functions.hpp>
 
 #include <QGridLayout>
@@ -81,11 +82,14 @@ InfoDock::InfoDock()
 
     buffer = new QLabel;
     bitrateAndFPS = new QLabel;
+    networkCache = new QLabel;
+    networkCache->close();
 
     layout = new QGridLayout(&mainW);
     layout->addWidget(infoE);
     layout->addWidget(buffer);
     layout->addWidget(bitrateAndFPS);
+    layout->addWidget(networkCache);
 
     QMargins margins = layout->contentsMargins();
     margins.setBottom(1);
@@ -210,6 +214,17 @@ void InfoDock::setLabelValues()
             text += ", " + tr("interlaced");
     }
     bitrateAndFPS->setText(text);
+
+    // Downloaded icons, thumbnails and covers
+    const auto &cache = NetworkCache::instance();
+    const quint64 hits = cache.hits();
+    const quint64 requests = hits + cache.misses();
+    if (requests > 0)
+    {
+        networkCache->setText(tr("Network cache hits") + QString(": %1 / %2").arg(hits).arg(requests));
+        if (!networkCache->isVisible())
+            networkCache->show();
+    }
 }
 void InfoDock::setBufferLabel()
 {
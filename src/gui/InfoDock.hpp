@@ -52,7 +52,7 @@ private:
 
     QWidget mainW;
     QGridLayout *layout;
-    QLabel *bitrateAndFPS, *buffer;
+    QLabel *bitrateAndFPS, *buffer, *networkCache;
     TextEdit *infoE;
 
     QString m_info;
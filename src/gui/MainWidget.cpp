@@ -28,6 +28,7 @@
 #include <QLabel>
 #include <QShortcut>
 #include <QFileDialog>
+#include <QFile>
 #include <QTreeWidget>
 #include <QListWidget>
 #include <QWindow>
@@ -60,6 +61,8 @@
 #include <InfoDock.hpp>
 #include <PlaylistDock.hpp>
 #include <Slider.hpp>
+#include <SeekPreview.hpp>
+#include <PlaylistSession.hpp>
 #include <Playlist.hpp>
 #include <AboutWidget.hpp>
 #include <AddressDialog.hpp>
@@ -374,6 +377,8 @@ MainWidget::MainWidget(QList<QPair<QString, QString>> &arguments)
     connect(&playC, &PlayClass::setStreamsMenu, this, &MainWidget::setStreamsMenu);
     connect(&playC, SIGNAL(updateCurrentEntry(const QString &, double)), playlistDock, SLOT(updateCurrentEntry(const QString &, double)));
     connect(&playC, SIGNAL(playNext(bool)), playlistDock, SLOT(next(bool)));
+    connect(&playC, &PlayClass::prefetchNext, playlistDock, &PlaylistDock::prefetchNext);
+    connect(playlistDock, &PlaylistDock::prefetch, &playC, &PlayClass::prefetch);
     connect(&playC, SIGNAL(clearCurrentPlaying()), playlistDock, SLOT(clearCurrentPlaying()));
     connect(&playC, &PlayClass::clearInfo, this, [this] {
         infoDock->clear();
@@ -512,7 +517,11 @@ MainWidget::MainWidget(QList<QPair<QString, QString>> &arguments)
         }
     });
 
-    playlistDock->load(QMPlay2Core.getSettingsDir() + "Playlist.pls");
+    const QString sessionPlaylist = QMPlay2Core.getSettingsDir() + "Playlist." + PlaylistSession::Extension;
+    if (QFile::exists(sessionPlaylist))
+        playlistDock->load(sessionPlaylist);
+    else
+        playlistDock->load(QMPlay2Core.getSettingsDir() + "Playlist.pls"); // Playlist from older versions
 
     bool noplay = false;
     for (const auto &argument : std::as_const(arguments))
@@ -1542,6 +1551,18 @@ void MainWidget::setSeekSMaximum(int max)
         seekSFocus = focus;
         seekS->setEnabled(false);
     }
+
+    const QString url = playC.getUrl();
+    if (max <= 0 || url.isEmpty() || !QMPlay2Core.getSettings().getBool("SeekPreview"))
+    {
+        m_seekPreview.reset();
+    }
+    else if (!m_seekPreview || m_seekPreview->url() != url)
+    {
+        m_seekPreview.reset();
+        if (url.startsWith("file://") || url.startsWith("http://") || url.startsWith("https://"))
+            m_seekPreview = std::make_unique<SeekPreview>(url, max);
+    }
 }
 void MainWidget::updatePos(double pos)
 {
@@ -1567,6 +1588,8 @@ void MainWidget::updatePos(double pos)
 void MainWidget::mousePositionOnSlider(int pos)
 {
     statusBar->showMessage(tr("Pointed position") + ": " + timeToStr(pos / 10.0, true), 750);
+    if (m_seekPreview)
+        seekS->setPreview(m_seekPreview->thumbnail(pos / 10.0));
 }
 
 void MainWidget::newConnection(IPCSocket *socket)
@@ -2225,7 +2248,7 @@ void MainWidget::closeEvent(QCloseEvent *e)
     {
         if (settings.getBool("AutoDelNonGroupEntries"))
             playlistDock->delNonGroupEntries(true);
-        playlistDock->save(QMPlay2Core.getSettingsDir() + "Playlist.pls");
+        playlistDock->saveSession(QMPlay2Core.getSettingsDir() + "Playlist." + PlaylistSession::Extension);
     }
 
     playC.stop(true);
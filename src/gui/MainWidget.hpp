@@ -27,6 +27,7 @@
 class QFrame;
 class QLabel;
 class Slider;
+class SeekPreview;
 class MenuBar;
 class InfoDock;
 class VideoDock;
@@ -189,6 +190,8 @@ private:
     Slider *seekS;
     VolWidget *volW;
 
+    std::unique_ptr<SeekPreview> m_seekPreview;
+
     PlayClass playC;
 
     QSystemTrayIcon *tray;
@@ -115,6 +115,9 @@ void PlayClass::play(const QString &_url)
 
             url = _url;
             demuxThr = new DemuxerThr(*this);
+            if (m_prefetch && m_prefetch->url() == url)
+                demuxThr->m_prefetch = std::move(m_prefetch);
+            m_prefetch.reset();
             demuxThr->minBuffSizeLocal = QMPlay2Core.getSettings().getInt("AVBufferLocal");
             demuxThr->m_minBuffTimeNetwork = QMPlay2Core.getSettings().getDouble("AVBufferTimeNetwork");
             demuxThr->m_minBuffTimeNetworkLive = QMPlay2Core.getSettings().getDouble("AVBufferTimeNetworkLive");
@@ -216,6 +219,8 @@ void PlayClass::stop(bool _quitApp)
         }
         else
         {
+            m_prefetch.reset();
+            cancelTransitionTimer();
             if (aThr)
                 aThr->setAllowAudioDrain();
             stopAVThr();
@@ -226,6 +231,15 @@ void PlayClass::stop(bool _quitApp)
         stopPauseMutex.unlock();
     }
 }
+void PlayClass::prefetch(const QString &url)
+{
+    if (!isPlaying() || url == this->url || !url.startsWith("file://"))
+        return;
+    if (m_prefetch && m_prefetch->url() == url)
+        return;
+    m_prefetch = std::make_unique<PrefetchThr>(url);
+    m_prefetch->start(QThread::LowPriority);
+}
 void PlayClass::restart()
 {
     if (!url.isEmpty())
@@ -781,6 +795,41 @@ inline void PlayClass::emitSetVideoCheckState()
     emit setVideoCheckState(rotate90, flip & Qt::Horizontal, flip & Qt::Vertical, spherical);
 }
 
+void PlayClass::startTransitionTimer()
+{
+    QMutexLocker locker(&m_transitionMutex);
+    m_transitionTimer.start();
+    m_transitionTime = -1.0;
+    m_transitionPending = true;
+}
+void PlayClass::cancelTransitionTimer()
+{
+    QMutexLocker locker(&m_transitionMutex);
+    m_transitionPending = false;
+    m_transitionTimer.invalidate();
+    m_transitionTime = -1.0;
+}
+void PlayClass::stopTransitionTimer()
+{
+    // Called by the audio and video threads for every written sample or frame
+    if (!m_transitionPending)
+        return;
+    {
+        QMutexLocker locker(&m_transitionMutex);
+        if (!m_transitionPending)
+            return;
+        m_transitionPending = false;
+        m_transitionTime = m_transitionTimer.nsecsElapsed() / 1e6;
+        m_transitionTimer.invalidate();
+    }
+    emit QMPlay2Core.updateInformationPanel();
+}
+double PlayClass::transitionTime() const
+{
+    QMutexLocker locker(&m_transitionMutex);
+    return m_transitionTime;
+}
+
 void PlayClass::suspendWhenFinished(bool b)
 {
     doSuspend = b;
@@ -1455,6 +1504,7 @@ void PlayClass::demuxThrFinished()
             stopAVThr();
         emit clearCurrentPlaying();
         canDoSuspend = false;
+        cancelTransitionTimer();
         play(newUrl);
         newUrl.clear();
         clr = false;
@@ -1470,6 +1520,7 @@ void PlayClass::demuxThrFinished()
                 stopAVThr();
             else
             {
+                startTransitionTimer();
                 emit playNext(err);
                 clr = false;
             }
@@ -28,9 +28,12 @@
 #include <QObject>
 #include <QStringList>
 #include <QWaitCondition>
+#include <QElapsedTimer>
 
 #include <memory>
+#include <atomic>
 
+class PrefetchThr;
 class StreamInfo;
 class QMPlay2OSD;
 class DemuxerThr;
@@ -60,6 +63,7 @@ public:
 
     Q_SLOT void play(const QString &);
     Q_SLOT void stop(bool quitApp = false);
+    Q_SLOT void prefetch(const QString &url);
     void restart();
 
     inline bool canUpdatePosition() const
@@ -145,6 +149,12 @@ private:
 
     inline void emitSetVideoCheckState();
 
+    // Time between the end of an entry and the first sample or frame of the next one
+    void startTransitionTimer();
+    void cancelTransitionTimer();
+    void stopTransitionTimer();
+    double transitionTime() const;
+
     DemuxerThr *demuxThr;
     VideoThr *vThr;
     AudioThr *aThr;
@@ -189,6 +199,12 @@ private:
     bool m_integerScaling = false;
     bool m_preciseZoom = false;
 
+    std::unique_ptr<PrefetchThr> m_prefetch;
+    mutable QMutex m_transitionMutex;
+    QElapsedTimer m_transitionTimer;
+    double m_transitionTime = -1.0;
+    std::atomic_bool m_transitionPending {false};
+
 private slots:
     void suspendWhenFinished(bool b);
     void repeatEntry(bool b);
@@ -259,6 +275,7 @@ signals:
     void setStreamsMenu(const QStringList &videoStreams, const QStringList &audioStreams, const QStringList &subsStreams, const QStringList &chapters, const QStringList &programs);
     void updateCurrentEntry(const QString &, double);
     void playNext(bool playingError);
+    void prefetchNext();
     void clearCurrentPlaying();
     void clearInfo();
     void quit();
@@ -20,6 +20,8 @@
 #include <PlaylistWidget.hpp>
 
 #include <EntryProperties.hpp>
+#include <PlaylistSession.hpp>
+#include <PlaylistSearch.hpp>
 #include <LineEdit.hpp>
 #include <Settings.hpp>
 #include <Main.hpp>
@@ -36,6 +38,7 @@
 #include <QAction>
 #include <QMessageBox>
 #include <QRandomGenerator>
+#include <QThread>
 
 static bool urlMatchesWithItem(QTreeWidgetItem *item, const QString &url)
 {
@@ -48,7 +51,8 @@ static bool urlMatchesWithItem(QTreeWidgetItem *item, const QString &url)
 
 PlaylistDock::PlaylistDock() :
     repeatMode(RepeatNormal),
-    lastPlaying(nullptr)
+    lastPlaying(nullptr),
+    m_randomPlayedParent(nullptr)
 {
     setWindowTitle(tr("Playlist"));
     setWidget(&mainW);
@@ -58,6 +62,10 @@ PlaylistDock::PlaylistDock() :
     findE->setToolTip(tr("Filter entries"));
     statusL = new QLabel;
 
+    m_search = std::make_unique<PlaylistSearch>(*list);
+    m_findTimer.setSingleShot(true);
+    m_findTimer.setInterval(150);
+
     setMode();
 
     QGridLayout *layout = new QGridLayout(&mainW);
@@ -73,7 +81,14 @@ PlaylistDock::PlaylistDock() :
     connect(list, SIGNAL(visibleItemsCount(int)), this, SLOT(visibleItemsCount(int)));
     connect(list, SIGNAL(addStatus(bool)), findE, SLOT(setDisabled(bool)));
     connect(findE, SIGNAL(textChanged(const QString &)), this, SLOT(findItems(const QString &)));
+    connect(&m_findTimer, SIGNAL(timeout()), this, SLOT(findItems()));
+    connect(m_search.get(), SIGNAL(found(const QString &)), this, SLOT(itemsFound(const QString &)));
     connect(findE, SIGNAL(returnPressed()), this, SLOT(findNext()));
+    connect(list->model(), SIGNAL(rowsInserted(const QModelIndex &, int, int)), this, SLOT(invalidateShuffle()));
+    connect(list->model(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)), this, SLOT(invalidateShuffle()));
+    connect(list->model(), SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)), this, SLOT(invalidateShuffle()));
+    connect(list->model(), SIGNAL(modelReset()), this, SLOT(invalidateShuffle()));
+    connect(list->model(), SIGNAL(layoutChanged()), this, SLOT(invalidateShuffle())); // Sorting
 
     QAction *act = new QAction(this);
     act->setShortcuts(QList<QKeySequence>() << QKeySequence("Return") << QKeySequence("Enter"));
@@ -82,6 +97,12 @@ PlaylistDock::PlaylistDock() :
     addAction(act);
 }
 
+PlaylistDock::~PlaylistDock()
+{
+    if (m_sessionWriter)
+        m_sessionWriter->wait();
+}
+
 void PlaylistDock::stopThreads()
 {
     list->updateEntryThr.stop();
@@ -106,16 +127,30 @@ void PlaylistDock::load(const QString &url)
 }
 bool PlaylistDock::save(const QString &_url, bool saveCurrentGroup)
 {
-    const QString url = Functions::Url(_url);
-    QList<QTreeWidgetItem *> parents;
+    return Playlist::write(getEntries(saveCurrentGroup), Functions::Url(_url));
+}
+void PlaylistDock::saveSession(const QString &filePath)
+{
+    if (m_sessionWriter)
+        m_sessionWriter->wait();
+    m_sessionWriter.reset(QThread::create([entries = getEntries(false), filePath] {
+        if (!PlaylistSession::write(entries, filePath))
+            QMPlay2Core.logError(tr("Can't save the playlist") + ": " + filePath);
+    }));
+    m_sessionWriter->start(QThread::LowPriority);
+}
+
+PlaylistEntries PlaylistDock::getEntries(bool saveCurrentGroup) const
+{
+    QHash<QTreeWidgetItem *, int> parents;
     Playlist::Entries entries;
     for (QTreeWidgetItem *tWI : list->getChildren(PlaylistWidget::ALL_CHILDREN, saveCurrentGroup ? list->currentItem() : nullptr))
     {
         Playlist::Entry entry;
         if (PlaylistWidget::isGroup(tWI))
         {
-            parents += tWI;
-            entry.GID = parents.size();
+            entry.GID = parents.size() + 1;
+            parents.insert(tWI, entry.GID);
         }
         else
         {
@@ -125,14 +160,14 @@ bool PlaylistDock::save(const QString &_url, bool saveCurrentGroup)
         entry.url = tWI->data(0, Qt::UserRole).toString();
         entry.name = tWI->text(0);
         if (tWI->parent())
-            entry.parent = parents.indexOf(tWI->parent()) + 1;
+            entry.parent = parents.value(tWI->parent());
         if (tWI == list->currentItem())
             entry.flags |= Playlist::Entry::Selected;
         entry.flags |= PlaylistWidget::getFlags(tWI); //Additional flags
         entry.params = tWI->data(0, Qt::UserRole + 1).value<QHash<QByteArray, QByteArray>>();
         entries += entry;
     }
-    return Playlist::write(entries, url);
+    return entries;
 }
 
 void PlaylistDock::add(const QStringList &urls)
@@ -268,6 +303,99 @@ inline bool PlaylistDock::isRandomPlayback() const
     return (repeatMode == RandomMode || repeatMode == RandomGroupMode || repeatMode == RepeatRandom || repeatMode == RepeatRandomGroup);
 }
 
+void PlaylistDock::addRandomPlayed(QTreeWidgetItem *tWI)
+{
+    if (randomPlayedItems.isEmpty())
+        m_randomPlayedParent = tWI->parent();
+    randomPlayedItems.insert(tWI);
+}
+void PlaylistDock::clearRandomPlayed()
+{
+    randomPlayedItems.clear();
+    m_shuffleItems.clear();
+}
+QTreeWidgetItem *PlaylistDock::takeRandomItem(const QList<QTreeWidgetItem *> &l)
+{
+    // Entries not played yet in the current round, drawn without replacement (Fisher-Yates)
+    if (m_shuffleItems.isEmpty())
+    {
+        m_shuffleItems.reserve(l.count());
+        for (QTreeWidgetItem *tWI : l)
+        {
+            if (!randomPlayedItems.contains(tWI))
+                m_shuffleItems.append(tWI);
+        }
+    }
+    QTreeWidgetItem *ret = nullptr;
+    bool lastPlayingDrawn = false;
+    while (!m_shuffleItems.isEmpty())
+    {
+        const int idx = QRandomGenerator::global()->bounded(m_shuffleItems.count());
+        QTreeWidgetItem *tWI = m_shuffleItems.at(idx);
+        m_shuffleItems[idx] = m_shuffleItems.last();
+        m_shuffleItems.removeLast();
+
+        // Entries played meanwhile by the user are removed lazily
+        if (randomPlayedItems.contains(tWI))
+            continue;
+        if (tWI == lastPlaying)
+        {
+            // Don't repeat the last one, but keep it for later in this round
+            lastPlayingDrawn = true;
+            continue;
+        }
+        if (PlaylistWidget::getFlags(tWI) & Playlist::Entry::Skip)
+        {
+            //Don't play skipped item
+            addRandomPlayed(tWI);
+            continue;
+        }
+        ret = tWI;
+        break;
+    }
+    if (lastPlayingDrawn)
+        m_shuffleItems.append(lastPlaying);
+    return ret;
+}
+
+const QList<QTreeWidgetItem *> &PlaylistDock::nonGroupItems()
+{
+    if (!m_nonGroupItemsValid)
+    {
+        m_nonGroupItems = list->getChildren(PlaylistWidget::ONLY_NON_GROUPS);
+        m_nonGroupIndexes.clear();
+        m_nonGroupIndexes.reserve(m_nonGroupItems.count());
+        for (int i = 0; i < m_nonGroupItems.count(); ++i)
+            m_nonGroupIndexes.insert(m_nonGroupItems.at(i), i);
+        m_nonGroupItemsValid = true;
+    }
+    return m_nonGroupItems;
+}
+const QList<QTreeWidgetItem *> &PlaylistDock::nonGroupItems(QTreeWidgetItem *parent)
+{
+    if (!m_groupItemsValid || m_groupItemsParent != parent)
+    {
+        m_groupItems = parent ? list->getChildren(PlaylistWidget::ONLY_NON_GROUPS, parent) : list->topLevelNonGroupsItems();
+        m_groupIndexes.clear();
+        m_groupIndexes.reserve(m_groupItems.count());
+        for (int i = 0; i < m_groupItems.count(); ++i)
+            m_groupIndexes.insert(m_groupItems.at(i), i);
+        m_groupItemsParent = parent;
+        m_groupItemsValid = true;
+    }
+    return m_groupItems;
+}
+int PlaylistDock::nonGroupItemIndex(QTreeWidgetItem *tWI)
+{
+    nonGroupItems();
+    return m_nonGroupIndexes.value(tWI, -1);
+}
+int PlaylistDock::nonGroupItemIndex(QTreeWidgetItem *tWI, QTreeWidgetItem *parent)
+{
+    nonGroupItems(parent);
+    return m_groupIndexes.value(tWI, -1);
+}
+
 void PlaylistDock::doGroupSync(bool quick, QTreeWidgetItem *tWI, bool quickRecursive)
 {
     if (!tWI || !PlaylistWidget::isGroup(tWI))
@@ -303,7 +431,7 @@ bool PlaylistDock::maybeDeleteTreeWidgetItem(QTreeWidgetItem *tWI)
 {
     if (PlaylistWidget::getFlags(tWI) & Playlist::Entry::Locked)
         return false;
-    randomPlayedItems.removeOne(tWI);
+    randomPlayedItems.remove(tWI);
     if (lastPlaying == tWI)
         lastPlaying = nullptr;
     delete tWI;
@@ -338,6 +466,13 @@ void PlaylistDock::finalizeItemsDelete(QTreeWidgetItem *par, bool deleted)
     }
 }
 
+void PlaylistDock::invalidateShuffle()
+{
+    m_shuffleItems.clear();
+    m_nonGroupItemsValid = false;
+    m_groupItemsValid = false;
+}
+
 void PlaylistDock::itemDoubleClicked(QTreeWidgetItem *tWI)
 {
     if (!tWI || PlaylistWidget::isGroup(tWI))
@@ -350,8 +485,8 @@ void PlaylistDock::itemDoubleClicked(QTreeWidgetItem *tWI)
     if (!list->currentPlaying || list->currentItem() == list->currentPlaying)
         list->setCurrentItem(tWI);
 
-    if (isRandomPlayback() && !randomPlayedItems.contains(tWI))
-        randomPlayedItems.append(tWI);
+    if (isRandomPlayback())
+        addRandomPlayed(tWI);
 
     lastPlaying = tWI;
 
@@ -411,8 +546,8 @@ void PlaylistDock::stopLoading()
 }
 void PlaylistDock::next(bool playingError)
 {
-    QList<QTreeWidgetItem *> l = list->getChildren(PlaylistWidget::ONLY_NON_GROUPS);
-    if (lastPlaying && !l.contains(lastPlaying))
+    QList<QTreeWidgetItem *> l = nonGroupItems();
+    if (lastPlaying && nonGroupItemIndex(lastPlaying) < 0)
         lastPlaying = nullptr;
     if (repeatMode == RepeatStopAfter)
     {
@@ -428,33 +563,19 @@ void PlaylistDock::next(bool playingError)
             {
                 QTreeWidgetItem *P = list->currentPlaying ? list->currentPlaying->parent() : (list->currentItem() ? list->currentItem()->parent() : nullptr);
                 expandTree(P);
-                l = P ? list->getChildren(PlaylistWidget::ONLY_NON_GROUPS, P) : list->topLevelNonGroupsItems();
-                if (l.isEmpty() || (!randomPlayedItems.isEmpty() && randomPlayedItems.at(0)->parent() != P))
-                    randomPlayedItems.clear();
+                l = nonGroupItems(P);
+                if (l.isEmpty() || (!randomPlayedItems.isEmpty() && m_randomPlayedParent != P))
+                    clearRandomPlayed();
             }
             const bool playedEverything = (randomPlayedItems.count() == l.count());
             if (playedEverything)
-                randomPlayedItems.clear();
+                clearRandomPlayed();
             if (!playedEverything || (repeatMode == RepeatRandom || (repeatMode == RepeatRandomGroup && !l.isEmpty())))
             {
                 if (l.count() == 1)
                     tWI = l.at(0);
-                else do
-                {
-                    tWI = l.at(QRandomGenerator::global()->bounded(l.count()));
-                    if (PlaylistWidget::getFlags(tWI) & Playlist::Entry::Skip)
-                    {
-                        //Don't play skipped item.
-                        if (!randomPlayedItems.contains(tWI))
-                            randomPlayedItems.append(tWI);
-                        if (randomPlayedItems.count() == l.count())
-                        {
-                            //Break and stop playback if played everything ignoring skipped entries
-                            tWI = nullptr;
-                            break;
-                        }
-                    }
-                } while (lastPlaying == tWI || randomPlayedItems.contains(tWI));
+                else
+                    tWI = takeRandomItem(l); //"nullptr" stops playback if played everything ignoring skipped entries
             }
         }
         else
@@ -483,7 +604,7 @@ void PlaylistDock::next(bool playingError)
                             tWI = list->itemBelow(tWI);
                             if (canRepeat && repeatMode == RepeatGroup && P && (!tWI || tWI->parent() != P)) //loop group
                             {
-                                const QList<QTreeWidgetItem *> l2 = list->getChildren(PlaylistWidget::ONLY_NON_GROUPS, P);
+                                const QList<QTreeWidgetItem *> &l2 = nonGroupItems(P);
                                 if (!l2.isEmpty())
                                     tWI = l2[0];
                                 break;
@@ -510,12 +631,49 @@ void PlaylistDock::next(bool playingError)
     if (playingError && tWI == list->currentItem()) //don't play the same song if playback error occurred
     {
         if (isRandomPlayback())
-            randomPlayedItems.append(tWI);
+            addRandomPlayed(tWI);
         emit stop();
     }
     else
         itemDoubleClicked(tWI);
 }
+void PlaylistDock::prefetchNext()
+{
+    // Predict the entry which will be played by "next()", random playback can't be predicted
+    if (isRandomPlayback() || repeatMode == RepeatEntry || repeatMode == RepeatStopAfter)
+        return;
+    if (!list->currentPlaying || (PlaylistWidget::getFlags(list->currentPlaying) & Playlist::Entry::StopAfter))
+        return;
+
+    QTreeWidgetItem *tWI = nullptr;
+    if (!list->queue.isEmpty())
+    {
+        tWI = list->queue.first();
+    }
+    else
+    {
+        QTreeWidgetItem *P = list->currentPlaying->parent();
+        const bool inGroup = (repeatMode == RepeatGroup && P);
+        const QList<QTreeWidgetItem *> l = inGroup ? nonGroupItems(P) : nonGroupItems();
+        const int idx = inGroup ? nonGroupItemIndex(list->currentPlaying, P) : nonGroupItemIndex(list->currentPlaying);
+        if (idx < 0)
+            return;
+        for (int i = idx + 1; i < idx + l.count(); ++i)
+        {
+            if (i >= l.count() && repeatMode != RepeatList && repeatMode != RepeatGroup)
+                break;
+            QTreeWidgetItem *item = l.at(i % l.count());
+            if (!(PlaylistWidget::getFlags(item) & Playlist::Entry::Skip))
+            {
+                tWI = item;
+                break;
+            }
+        }
+    }
+
+    if (tWI)
+        emit prefetch(tWI->data(0, Qt::UserRole).toString());
+}
 void PlaylistDock::prev()
 {
     QTreeWidgetItem *tWI = nullptr;
@@ -764,8 +922,23 @@ void PlaylistDock::queue()
 }
 void PlaylistDock::findItems(const QString &txt)
 {
-    QList<QTreeWidgetItem *> itemsToShow = list->findItems(txt, Qt::MatchContains | Qt::MatchRecursive);
-    list->processItems(&itemsToShow, !txt.isEmpty());
+    // Wait for the user to stop typing, but restore the full list immediately
+    if (txt.isEmpty())
+    {
+        m_findTimer.stop();
+        m_search->find(txt);
+    }
+    else
+    {
+        m_findTimer.start();
+    }
+}
+void PlaylistDock::findItems()
+{
+    m_search->find(findE->text());
+}
+void PlaylistDock::itemsFound(const QString &txt)
+{
     if (txt.isEmpty())
     {
         const QList<QTreeWidgetItem *> selectedItems = list->selectedItems();
@@ -830,7 +1003,7 @@ void PlaylistDock::repeat()
                 case RandomGroupMode:
                 case RepeatRandom:
                 case RepeatRandomGroup:
-                    randomPlayedItems.clear();
+                    clearRandomPlayed();
                     break;
                 default:
                     break;
@@ -838,7 +1011,7 @@ void PlaylistDock::repeat()
             if (list->currentPlaying && isRandomPlayback())
             {
                 Q_ASSERT(randomPlayedItems.isEmpty());
-                randomPlayedItems.append(list->currentPlaying);
+                addRandomPlayed(list->currentPlaying);
             }
             emit QMPlay2Core.statusBarMessage(act->text().remove('&'), 1500);
         }
@@ -18,10 +18,20 @@
 
 #pragma once
 
+#include <PlaylistEntry.hpp>
 #include <DockWidget.hpp>
 #include <RepeatMode.hpp>
 
+#include <QVector>
+#include <QHash>
+#include <QTimer>
+#include <QSet>
+
+#include <memory>
+
 class QTreeWidgetItem;
+class QThread;
+class PlaylistSearch;
 class PlaylistWidget;
 class LineEdit;
 class QLabel;
@@ -31,6 +41,7 @@ class PlaylistDock : public DockWidget
     Q_OBJECT
 public:
     PlaylistDock();
+    ~PlaylistDock();
 
     void stopThreads();
 
@@ -39,6 +50,7 @@ public:
 
     void load(const QString &);
     bool save(const QString &, bool saveCurrentGroup = false);
+    void saveSession(const QString &filePath);
 
     void add(const QStringList &);
     void addAndPlay(const QStringList &);
@@ -61,12 +73,23 @@ private:
     void showEvent(QShowEvent *e) override;
 
 private:
+    PlaylistEntries getEntries(bool saveCurrentGroup) const;
+
     void expandTree(QTreeWidgetItem *);
 
     void toggleEntryFlag(const int flag);
 
     inline bool isRandomPlayback() const;
 
+    void addRandomPlayed(QTreeWidgetItem *tWI);
+    void clearRandomPlayed();
+    QTreeWidgetItem *takeRandomItem(const QList<QTreeWidgetItem *> &l);
+
+    const QList<QTreeWidgetItem *> &nonGroupItems();
+    const QList<QTreeWidgetItem *> &nonGroupItems(QTreeWidgetItem *parent);
+    int nonGroupItemIndex(QTreeWidgetItem *tWI);
+    int nonGroupItemIndex(QTreeWidgetItem *tWI, QTreeWidgetItem *parent);
+
     void doGroupSync(bool quick, QTreeWidgetItem *tWI, bool quickRecursive = true);
 
     bool maybeDeleteTreeWidgetItem(QTreeWidgetItem *tWI);
@@ -83,14 +106,29 @@ private:
 
     bool playAfterAdd;
     QTreeWidgetItem *lastPlaying;
-    QList<QTreeWidgetItem *> randomPlayedItems;
+    QSet<QTreeWidgetItem *> randomPlayedItems;
+    QTreeWidgetItem *m_randomPlayedParent;
+    QVector<QTreeWidgetItem *> m_shuffleItems;
+
+    // Entries for "next()", valid until the playlist structure changes
+    QList<QTreeWidgetItem *> m_nonGroupItems, m_groupItems;
+    QHash<QTreeWidgetItem *, int> m_nonGroupIndexes, m_groupIndexes;
+    QTreeWidgetItem *m_groupItemsParent = nullptr;
+    bool m_nonGroupItemsValid = false, m_groupItemsValid = false;
+
+    std::unique_ptr<QThread> m_sessionWriter;
+
+    std::unique_ptr<PlaylistSearch> m_search;
+    QTimer m_findTimer;
 private slots:
+    void invalidateShuffle();
     void itemDoubleClicked(QTreeWidgetItem *);
     void addAndPlay(QTreeWidgetItem *);
     void maybeDoQuickSync(QTreeWidgetItem *item);
 public slots:
     void stopLoading();
     void next(bool playingError = false);
+    void prefetchNext();
     void prev();
     void skip();
     void stopAfter();
@@ -118,6 +156,8 @@ public slots:
     void goToPlayback();
     void queue();
     void findItems(const QString &);
+    void findItems();
+    void itemsFound(const QString &txt);
     void findNext();
     void visibleItemsCount(int);
     void syncCurrentFolder();
@@ -126,6 +166,7 @@ public slots:
     void updateCurrentEntry(const QString &, double);
 signals:
     void play(const QString &);
+    void prefetch(const QString &url);
     void repeatEntry(bool b);
     void stop();
     void addAndPlayRestoreWindow();
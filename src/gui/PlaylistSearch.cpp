@@ -0,0 +1,262 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <PlaylistSearch.hpp>
+
+#include <PlaylistWidget.hpp>
+
+constexpr int g_abortCheckInterval = 4096;
+
+PlaylistSearch::PlaylistSearch(PlaylistWidget &list)
+    : m_list(list)
+{
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+
+    rebuild();
+
+    // Keep the index up to date, so the search doesn't have to walk the whole playlist.
+    // Moving and sorting entries doesn't change the search results.
+    QAbstractItemModel *model = m_list.model();
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last) {
+        addItems(parent, first, last);
+    });
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        removeItems(parent, first, last);
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, [this] {
+        rebuild();
+    });
+    connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
+        // Only the entry name and URL are searched, ignore icons, fonts, queue numbers and lengths
+        if (topLeft.column() == 0 && (roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(Qt::UserRole)))
+            updateItems(topLeft.parent(), topLeft.row(), bottomRight.row());
+    });
+    connect(this, SIGNAL(matchedInternal(quint64, const QString &, const QVector<int> &)), this, SLOT(matched(quint64, const QString &, const QVector<int> &)), Qt::QueuedConnection);
+
+    start(QThread::LowPriority);
+}
+PlaylistSearch::~PlaylistSearch()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_br = true;
+        m_cond.wakeOne();
+    }
+    wait();
+}
+
+void PlaylistSearch::find(const QString &text)
+{
+    m_text = text;
+
+    QMutexLocker locker(&m_mutex);
+    m_request.text = text.toCaseFolded();
+    m_request.names = m_names;
+    m_request.urls = m_urls;
+    m_request.generation = m_generation;
+    m_hasRequest = true;
+    m_cond.wakeOne();
+}
+
+void PlaylistSearch::rebuild()
+{
+    m_items.clear();
+    m_names.clear();
+    m_urls.clear();
+    m_indexes.clear();
+    m_freeIndexes.clear();
+    m_matched.clear();
+    const int count = m_list.topLevelItemCount();
+    for (int i = 0; i < count; ++i)
+        addItem(m_list.topLevelItem(i));
+    ++m_generation;
+}
+
+void PlaylistSearch::addItems(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        if (QTreeWidgetItem *tWI = m_list.itemFromIndex(m_list.model()->index(row, 0, parent)))
+            addItem(tWI);
+    }
+    ++m_generation;
+}
+void PlaylistSearch::removeItems(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        if (QTreeWidgetItem *tWI = m_list.itemFromIndex(m_list.model()->index(row, 0, parent)))
+            removeItem(tWI);
+    }
+    ++m_generation;
+}
+void PlaylistSearch::updateItems(const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        const int idx = m_indexes.value(m_list.itemFromIndex(m_list.model()->index(row, 0, parent)), -1);
+        if (idx > -1)
+            updateItem(idx);
+    }
+    ++m_generation;
+}
+
+void PlaylistSearch::addItem(QTreeWidgetItem *tWI)
+{
+    int idx = m_indexes.value(tWI, -1);
+    if (idx < 0)
+    {
+        if (m_freeIndexes.isEmpty())
+        {
+            idx = m_items.size();
+            m_items.append(nullptr);
+            m_names.append(QString());
+            m_urls.append(QString());
+        }
+        else
+        {
+            idx = m_freeIndexes.takeLast();
+        }
+        m_items[idx] = tWI;
+        m_indexes.insert(tWI, idx);
+    }
+    updateItem(idx);
+
+    // New entries are visible until the next search
+    m_matched.insert(tWI);
+
+    const int count = tWI->childCount();
+    for (int i = 0; i < count; ++i)
+        addItem(tWI->child(i));
+}
+void PlaylistSearch::removeItem(QTreeWidgetItem *tWI)
+{
+    const int idx = m_indexes.value(tWI, -1);
+    if (idx > -1)
+    {
+        m_indexes.remove(tWI);
+        m_items[idx] = nullptr;
+        m_names[idx].clear();
+        m_urls[idx].clear();
+        m_freeIndexes.append(idx);
+    }
+    m_matched.remove(tWI);
+
+    const int count = tWI->childCount();
+    for (int i = 0; i < count; ++i)
+        removeItem(tWI->child(i));
+}
+void PlaylistSearch::updateItem(int idx)
+{
+    QTreeWidgetItem *tWI = m_items.at(idx);
+    m_names[idx] = tWI->text(0).toCaseFolded();
+    m_urls[idx] = tWI->data(0, Qt::UserRole).toString().toCaseFolded();
+}
+
+void PlaylistSearch::run()
+{
+    quint64 lastGeneration = 0;
+    QString lastText;
+    QVector<int> lastIndexes;
+    bool hasLast = false;
+
+    QMutexLocker locker(&m_mutex);
+    for (;;)
+    {
+        while (!m_br && !m_hasRequest)
+            m_cond.wait(&m_mutex);
+        if (m_br)
+            break;
+
+        const Request request = std::move(m_request);
+        m_request = Request();
+        m_hasRequest = false;
+        locker.unlock();
+
+        // Typing more characters only narrows the previous result
+        const bool narrow = (hasLast && request.generation == lastGeneration && request.text.contains(lastText));
+        const int count = narrow ? lastIndexes.size() : request.names.size();
+
+        QVector<int> indexes;
+        bool aborted = false;
+        for (int i = 0; i < count; ++i)
+        {
+            if ((i % g_abortCheckInterval) == 0 && m_hasRequest)
+            {
+                aborted = true;
+                break;
+            }
+            const int idx = narrow ? lastIndexes.at(i) : i;
+            if (request.names.at(idx).contains(request.text) || request.urls.at(idx).contains(request.text))
+                indexes.append(idx);
+        }
+
+        if (!aborted)
+        {
+            lastGeneration = request.generation;
+            lastText = request.text;
+            lastIndexes = indexes;
+            hasLast = true;
+            emit matchedInternal(request.generation, request.text, indexes);
+        }
+
+        locker.relock();
+    }
+}
+
+void PlaylistSearch::matched(quint64 generation, const QString &text, const QVector<int> &indexes)
+{
+    if (text != m_text.toCaseFolded())
+        return; // Superseded by a newer request
+    if (generation != m_generation)
+    {
+        // The playlist has been modified in the meantime, the indexes are no longer valid
+        find(m_text);
+        return;
+    }
+
+    QSet<QTreeWidgetItem *> items;
+    items.reserve(indexes.size());
+    int visibleCount = 0;
+    for (const int idx : indexes)
+    {
+        QTreeWidgetItem *tWI = m_items.at(idx);
+        if (!tWI)
+            continue; // Free slot
+        items.insert(tWI);
+        if (!PlaylistWidget::isGroup(tWI))
+            ++visibleCount;
+    }
+
+    // Apply only the difference against the previous search
+    QSet<QTreeWidgetItem *> itemsToShow, itemsToHide;
+    for (QTreeWidgetItem *tWI : std::as_const(items))
+    {
+        if (!m_matched.contains(tWI))
+            itemsToShow.insert(tWI);
+    }
+    for (QTreeWidgetItem *tWI : std::as_const(m_matched))
+    {
+        if (!items.contains(tWI))
+            itemsToHide.insert(tWI);
+    }
+    m_matched = std::move(items);
+
+    m_list.setItemsVisibility(m_matched, itemsToShow, itemsToHide, !m_text.isEmpty(), visibleCount, m_matched.size() < m_indexes.size());
+    emit found(m_text);
+}
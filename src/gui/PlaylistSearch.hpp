@@ -0,0 +1,90 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QWaitCondition>
+#include <QVector>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+
+#include <atomic>
+
+class QTreeWidgetItem;
+class PlaylistWidget;
+class QModelIndex;
+
+/* Matches playlist entry names and URLs against the filter text in background */
+class PlaylistSearch final : public QThread
+{
+    Q_OBJECT
+
+    struct Request
+    {
+        QString text;
+        QVector<QString> names, urls;
+        quint64 generation = 0;
+    };
+
+public:
+    PlaylistSearch(PlaylistWidget &list);
+    ~PlaylistSearch();
+
+    void find(const QString &text);
+
+private:
+    void rebuild();
+
+    void addItems(const QModelIndex &parent, int first, int last);
+    void removeItems(const QModelIndex &parent, int first, int last);
+    void updateItems(const QModelIndex &parent, int first, int last);
+
+    void addItem(QTreeWidgetItem *tWI);
+    void removeItem(QTreeWidgetItem *tWI);
+    void updateItem(int idx);
+
+    void run() override;
+
+private slots:
+    void matched(quint64 generation, const QString &text, const QVector<int> &indexes);
+
+signals:
+    void found(const QString &text);
+    void matchedInternal(quint64 generation, const QString &text, const QVector<int> &indexes);
+
+private:
+    PlaylistWidget &m_list;
+
+    // GUI thread, updated on every playlist modification, removed entries leave free slots
+    QVector<QTreeWidgetItem *> m_items;
+    QVector<QString> m_names, m_urls;
+    QHash<QTreeWidgetItem *, int> m_indexes;
+    QVector<int> m_freeIndexes;
+    QSet<QTreeWidgetItem *> m_matched; // Entries visible after the last search
+    quint64 m_generation = 0;
+    QString m_text;
+
+    // Shared with the search thread
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    Request m_request;
+    std::atomic_bool m_hasRequest {false};
+    bool m_br = false;
+};
@@ -655,6 +655,7 @@ PlaylistWidget::PlaylistWidget() :
     setIndentation(12);
     setColumnCount(3);
     setAnimated(true);
+    setUniformRowHeights(true); // Lets the view lay out only the visible rows
     header()->setStretchLastSection(false);
     setHeaderHidden(true);
     header()->setSectionResizeMode(0, QHeaderView::Stretch);
@@ -815,6 +816,11 @@ QList <QTreeWidgetItem * > PlaylistWidget::getChildren(CHILDREN children, const
     QList<QTreeWidgetItem *> list;
     if (!parent)
         parent = invisibleRootItem();
+    appendChildren(list, children, parent);
+    return list;
+}
+void PlaylistWidget::appendChildren(QList<QTreeWidgetItem *> &list, CHILDREN children, const QTreeWidgetItem *parent)
+{
     const int count = parent->childCount();
     for (int i = 0; i < count; i++)
     {
@@ -824,11 +830,10 @@ QList <QTreeWidgetItem * > PlaylistWidget::getChildren(CHILDREN children, const
         (
             ((children & ONLY_NON_GROUPS) && !group) ||
             ((children & ONLY_GROUPS)     &&  group)
-        ) list += tWI;
+        ) list.append(tWI);
         if (group)
-            list += getChildren(children, tWI);
+            appendChildren(list, children, tWI);
     }
-    return list;
 }
 
 bool PlaylistWidget::canModify(bool all) const
@@ -869,7 +874,14 @@ void PlaylistWidget::enqueue()
 }
 void PlaylistWidget::refresh(REFRESH Refresh)
 {
-    const QList<QTreeWidgetItem *> items = getChildren(ONLY_NON_GROUPS);
+    QSet<QTreeWidgetItem *> items;
+    if (Refresh & (REFRESH_QUEUE | REFRESH_CURRPLAYING))
+    {
+        const QList<QTreeWidgetItem *> itemsList = getChildren(ONLY_NON_GROUPS);
+        items.reserve(itemsList.size());
+        for (QTreeWidgetItem *tWI : itemsList)
+            items.insert(tWI);
+    }
     if (Refresh & REFRESH_QUEUE)
     {
         for (int i = 0; i < queue.size(); i++)
@@ -883,41 +895,42 @@ void PlaylistWidget::refresh(REFRESH Refresh)
     }
     if (Refresh & REFRESH_GROUPS_TIME)
     {
+        // Groups are listed parent-first, so walk backwards to have nested groups already summed
         const QList<QTreeWidgetItem *> groups = getChildren(ONLY_GROUPS);
         for (int i = groups.size() - 1; i >= 0; i--)
         {
+            QTreeWidgetItem *group = groups.at(i);
             double length = 0.0;
-            for (QTreeWidgetItem *tWI : getChildren(ALL_CHILDREN, groups.at(i)))
+            const int count = group->childCount();
+            for (int c = 0; c < count; c++)
             {
-                if (tWI->parent() != groups.at(i))
-                    continue;
-                const double l = tWI->data(2, Qt::UserRole).toDouble();
+                const double l = group->child(c)->data(2, Qt::UserRole).toDouble();
                 if (l > 0.0)
                     length += l;
             }
             const bool hasLength = !qFuzzyIsNull(length);
-            groups.at(i)->setText(2, hasLength ? Functions::timeToStr(length) : QString());
-            groups.at(i)->setData(2, Qt::UserRole, hasLength ? length : QVariant());
+            group->setText(2, hasLength ? Functions::timeToStr(length) : QString());
+            group->setData(2, Qt::UserRole, hasLength ? length : QVariant());
         }
     }
     if ((Refresh & REFRESH_CURRPLAYING) && !items.contains(currentPlaying))
         clearCurrentPlaying(false);
 }
 
-void PlaylistWidget::processItems(QList<QTreeWidgetItem *> *itemsToShow, bool hideGroups)
+void PlaylistWidget::processItems(const QSet<QTreeWidgetItem *> *itemsToShow, bool hideGroups)
 {
     int count = 0;
     hasHiddenItems = false;
     for (QTreeWidgetItem *tWI : getChildren(PlaylistWidget::ONLY_NON_GROUPS))
     {
-        if (itemsToShow)
+        bool hidden = tWI->isHidden();
+        if (itemsToShow && hidden != !itemsToShow->contains(tWI))
         {
-            const int idx = itemsToShow->indexOf(tWI);
-            tWI->setHidden(idx < 0);
-            if (idx > -1)
-                itemsToShow->removeAt(idx);
+            // Each call schedules the view relayout, so don't touch unchanged items
+            hidden = !hidden;
+            tWI->setHidden(hidden);
         }
-        if (tWI->isHidden())
+        if (hidden)
             hasHiddenItems = true;
         else
             count++;
@@ -927,7 +940,7 @@ void PlaylistWidget::processItems(QList<QTreeWidgetItem *> *itemsToShow, bool hi
     if (!itemsToShow)
         return;
 
-    // Hide empty groups which doesn't exist in "itemsToShow" list
+    // Hide empty groups which doesn't exist in "itemsToShow" list, nested groups are processed first
     const QList<QTreeWidgetItem *> groups = getChildren(ONLY_GROUPS);
     for (int i = groups.size() - 1; i >= 0; i--)
     {
@@ -935,9 +948,10 @@ void PlaylistWidget::processItems(QList<QTreeWidgetItem *> *itemsToShow, bool hi
         if (hideGroups && !itemsToShow->contains(group))
         {
             bool hasVisibleItems = false;
-            for (QTreeWidgetItem *tWI : getChildren(ALL_CHILDREN, group))
+            const int childCount = group->childCount();
+            for (int c = 0; c < childCount; c++)
             {
-                if (!tWI->isHidden())
+                if (!group->child(c)->isHidden())
                 {
                     hasVisibleItems = true;
                     break;
@@ -952,6 +966,59 @@ void PlaylistWidget::processItems(QList<QTreeWidgetItem *> *itemsToShow, bool hi
     }
 }
 
+void PlaylistWidget::setItemsVisibility(const QSet<QTreeWidgetItem *> &matched, const QSet<QTreeWidgetItem *> &itemsToShow, const QSet<QTreeWidgetItem *> &itemsToHide, bool hideGroups, int visibleCount, bool hasHidden)
+{
+    // Only the changed entries and groups containing them are touched
+    QSet<QTreeWidgetItem *> groups;
+    const auto setHidden = [&](QTreeWidgetItem *tWI, bool hidden) {
+        if (!isGroup(tWI) && tWI->isHidden() != hidden)
+            tWI->setHidden(hidden);
+        for (QTreeWidgetItem *group = isGroup(tWI) ? tWI : tWI->parent(); group && !groups.contains(group); group = group->parent())
+            groups.insert(group);
+    };
+    for (QTreeWidgetItem *tWI : itemsToShow)
+        setHidden(tWI, false);
+    for (QTreeWidgetItem *tWI : itemsToHide)
+        setHidden(tWI, true);
+
+    hasHiddenItems = hasHidden;
+    emit visibleItemsCount(visibleCount);
+
+    // Hide empty groups which doesn't match, nested groups are processed first
+    QVector<QPair<int, QTreeWidgetItem *>> sortedGroups;
+    sortedGroups.reserve(groups.size());
+    for (QTreeWidgetItem *group : std::as_const(groups))
+    {
+        int depth = 0;
+        for (QTreeWidgetItem *parent = group->parent(); parent; parent = parent->parent())
+            ++depth;
+        sortedGroups.append({depth, group});
+    }
+    std::sort(sortedGroups.begin(), sortedGroups.end(), [](const QPair<int, QTreeWidgetItem *> &a, const QPair<int, QTreeWidgetItem *> &b) {
+        return a.first > b.first;
+    });
+    for (auto &&sortedGroup : std::as_const(sortedGroups))
+    {
+        QTreeWidgetItem *group = sortedGroup.second;
+        bool hidden = false;
+        if (hideGroups && !matched.contains(group))
+        {
+            hidden = true;
+            const int childCount = group->childCount();
+            for (int c = 0; c < childCount; c++)
+            {
+                if (!group->child(c)->isHidden())
+                {
+                    hidden = false;
+                    break;
+                }
+            }
+        }
+        if (group->isHidden() != hidden)
+            group->setHidden(hidden);
+    }
+}
+
 bool PlaylistWidget::isAlwaysSynced(QTreeWidgetItem *tWI, bool parentOnly)
 {
     if (QTreeWidgetItem *item = ((parentOnly && tWI) ? tWI->parent() : tWI))
@@ -28,6 +28,7 @@
 #include <QQueue>
 #include <QMutex>
 #include <QTimer>
+#include <QSet>
 #include <QUrl>
 
 class QTreeWidgetItem;
@@ -122,10 +123,17 @@ signals:
     void status(bool s);
 };
 
+/*
+ * Every entry is a heap "QTreeWidgetItem" and per-item work runs on the GUI thread.
+ * Replacing it with a "QAbstractItemModel" over a contiguous entry store is a separate task,
+ * "QTreeWidgetItem" pointers are used directly by "PlaylistDock", "AddThr", "UpdateEntryThr",
+ * "PlaylistSearch", "EntryProperties" and the menus.
+ */
 class PlaylistWidget final : public QTreeWidget
 {
     friend class AddThr;
     friend class UpdateEntryThr;
+    friend class PlaylistSearch;
     Q_OBJECT
 public:
     enum CHILDREN {ONLY_GROUPS = 0x10, ONLY_NON_GROUPS = 0x100, ALL_CHILDREN = ONLY_GROUPS | ONLY_NON_GROUPS};
@@ -163,7 +171,8 @@ public:
     void enqueue();
     void refresh(REFRESH Refresh = REFRESH_ALL);
 
-    void processItems(QList<QTreeWidgetItem *> *itemsToShow = nullptr, bool hideGroups = false);
+    void processItems(const QSet<QTreeWidgetItem *> *itemsToShow = nullptr, bool hideGroups = false);
+    void setItemsVisibility(const QSet<QTreeWidgetItem *> &matched, const QSet<QTreeWidgetItem *> &itemsToShow, const QSet<QTreeWidgetItem *> &itemsToHide, bool hideGroups, int visibleCount, bool hasHidden);
 
     QString currentPlayingUrl;
     QTreeWidgetItem *currentPlaying;
@@ -189,6 +198,8 @@ public:
 
     static void setEntryFont(QTreeWidgetItem *tWI, const int flags);
 private:
+    static void appendChildren(QList<QTreeWidgetItem *> &list, CHILDREN children, const QTreeWidgetItem *parent);
+
     QTreeWidgetItem *newGroup(const QString &name, const QString &url, QTreeWidgetItem *parent, int insertChildAt, QStringList *existingEntries);
     QTreeWidgetItem *newEntry(const Playlist::Entry &entry, QTreeWidgetItem *parent, const Functions::DemuxersInfo &demuxersInfo, int insertChildAt, QStringList *existingEntries);
 
@@ -0,0 +1,66 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <PrefetchThr.hpp>
+
+#include <Demuxer.hpp>
+
+constexpr size_t g_maxPackets = 512;
+constexpr double g_maxDuration = 2.0;
+
+PrefetchThr::PrefetchThr(const QString &url)
+    : m_url(url)
+{}
+PrefetchThr::~PrefetchThr()
+{
+    abort();
+    wait();
+}
+
+void PrefetchThr::abort()
+{
+    demuxer.abort();
+}
+
+void PrefetchThr::run()
+{
+    if (!Demuxer::create(m_url, demuxer) || demuxer.isAborted())
+    {
+        demuxer.reset();
+        return;
+    }
+
+    double firstTs = -1.0;
+    while (!demuxer.isAborted() && packets.size() < g_maxPackets)
+    {
+        Packet packet;
+        int streamIdx = -1;
+        if (!demuxer->read(packet, streamIdx))
+            break;
+        if (streamIdx < 0)
+            continue;
+
+        const double ts = packet.ts();
+        packets.emplace_back(streamIdx, std::move(packet));
+
+        if (firstTs < 0.0)
+            firstTs = ts;
+        else if (ts - firstTs >= g_maxDuration)
+            break;
+    }
+}
@@ -0,0 +1,56 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <IOController.hpp>
+#include <Packet.hpp>
+
+#include <QString>
+#include <QThread>
+
+#include <utility>
+#include <deque>
+
+class Demuxer;
+
+/* Opens the next playlist entry in background and buffers its first packets */
+class PrefetchThr final : public QThread
+{
+public:
+    using PrefetchedPackets = std::deque<std::pair<int, Packet>>;
+
+    PrefetchThr(const QString &url);
+    ~PrefetchThr();
+
+    inline QString url() const
+    {
+        return m_url;
+    }
+
+    void abort();
+
+    IOController<Demuxer> demuxer;
+    PrefetchedPackets packets;
+
+private:
+    void run() override;
+
+private:
+    const QString m_url;
+};
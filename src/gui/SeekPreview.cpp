@@ -0,0 +1,321 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <SeekPreview.hpp>
+
+#include <QMPlay2Core.hpp>
+#include <StreamInfo.hpp>
+#include <Functions.hpp>
+#include <ImgScaler.hpp>
+#include <Demuxer.hpp>
+#include <Decoder.hpp>
+#include <Frame.hpp>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QPainter>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QFile>
+#include <QDir>
+
+#include <cmath>
+
+constexpr quint32 g_cacheVersion = 2;
+constexpr qint64 g_maxCacheSize = 64 * 1024 * 1024;
+constexpr double g_minInterval = 2.0;
+constexpr int g_maxThumbnails = 200;
+constexpr int g_thumbnailWidth = 160;
+constexpr int g_spriteColumns = 10;
+constexpr int g_maxPacketsPerThumbnail = 256;
+
+static QString getCacheFile(const QString &url)
+{
+    QByteArray key = url.toUtf8();
+    if (url.startsWith("file://"))
+    {
+        const QFileInfo fileInfo(url.mid(7));
+        key += QByteArray::number(fileInfo.size()) + QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch());
+    }
+    return QMPlay2Core.getCacheDir() + "Thumbnails/" + QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+}
+
+/* SeekPreviewThr */
+
+SeekPreviewThr::SeekPreviewThr(const QString &url, double interval, std::vector<int> &&indexes)
+    : m_url(url)
+    , m_interval(interval)
+    , m_indexes(std::move(indexes))
+{
+    setObjectName("SeekPreviewThr");
+}
+SeekPreviewThr::~SeekPreviewThr()
+{
+    abort();
+    wait();
+}
+
+void SeekPreviewThr::abort()
+{
+    m_demuxer.abort();
+}
+
+void SeekPreviewThr::run()
+{
+    if (!Demuxer::create(m_url, m_demuxer) || m_demuxer.isAborted())
+    {
+        m_demuxer.reset();
+        return;
+    }
+
+    const QList<StreamInfo *> streams = m_demuxer->streamsInfo();
+    int videoStream = -1;
+    for (int i = 0; i < streams.count(); ++i)
+    {
+        if (streams[i]->params->codec_type == AVMEDIA_TYPE_VIDEO)
+        {
+            videoStream = i;
+            break;
+        }
+    }
+    if (videoStream < 0)
+        return;
+
+    m_demuxer->selectStreams({videoStream});
+
+    // Always use software decoder - hardware surfaces are reserved for the playback
+    std::unique_ptr<Decoder> decoder(Decoder::create(*streams[videoStream], {"FFmpeg Decoder"}, nullptr, true));
+    if (!decoder)
+        return;
+    decoder->setSupportedPixelFormats({
+        AV_PIX_FMT_YUV420P,
+        AV_PIX_FMT_YUVJ420P,
+        AV_PIX_FMT_YUV422P,
+        AV_PIX_FMT_YUVJ422P,
+        AV_PIX_FMT_YUV444P,
+        AV_PIX_FMT_YUVJ444P,
+        AV_PIX_FMT_NV12,
+        AV_PIX_FMT_GRAY8,
+    });
+
+    double aspectRatio = streams[videoStream]->getAspectRatio();
+
+    ImgScaler imgScaler;
+    QSize scaledSize;
+
+    for (const int idx : m_indexes)
+    {
+        if (m_demuxer.isAborted())
+            break;
+
+        if (!m_demuxer->seek(idx * m_interval, true))
+            continue;
+
+        Frame decoded;
+        bool flush = true, hasKeyFrame = false;
+        for (int i = 0; i < g_maxPacketsPerThumbnail && decoded.isEmpty() && !m_demuxer.isAborted(); ++i)
+        {
+            Packet packet;
+            int streamIdx = -1;
+            if (!m_demuxer->read(packet, streamIdx))
+                break;
+            if (streamIdx != videoStream)
+                continue;
+
+            // Start from the key frame, so no references are missing
+            if (!hasKeyFrame && !(hasKeyFrame = packet.hasKeyFrame()))
+                continue;
+
+            AVPixelFormat newPixFmt = AV_PIX_FMT_NONE;
+            if (decoder->decodeVideo(packet, decoded, newPixFmt, flush, 0) < 0)
+                break;
+            flush = false;
+        }
+        if (decoded.isEmpty() || !decoded.hasCPUAccess())
+            continue;
+
+        if (!scaledSize.isValid())
+        {
+            if (aspectRatio <= 0.0 || !std::isfinite(aspectRatio))
+                aspectRatio = static_cast<double>(decoded.width()) / decoded.height();
+            scaledSize = QSize(g_thumbnailWidth, qBound(16, static_cast<int>(std::round(g_thumbnailWidth / aspectRatio)) & ~1, g_thumbnailWidth * 2));
+        }
+        if (!imgScaler.create(decoded, scaledSize.width(), scaledSize.height()))
+            return;
+
+        QImage img(scaledSize, QImage::Format_RGB32);
+        if (imgScaler.scale(decoded, img.bits()))
+            emit thumbnail(idx, img);
+    }
+
+    m_completed = !m_demuxer.isAborted();
+}
+
+/* SeekPreview */
+
+SeekPreview::SeekPreview(const QString &url, double length)
+    : m_url(url)
+    , m_cacheFile(getCacheFile(url))
+{
+    if (load())
+        return;
+
+    m_interval = qMax(g_minInterval, length / g_maxThumbnails);
+    m_count = qMax<int>(1, std::ceil(length / m_interval));
+    m_ready.resize(m_count);
+
+    // Coarse to fine, so the whole range gets some previews quickly
+    std::vector<int> order;
+    order.reserve(m_count);
+    QBitArray added(m_count);
+    for (int stride = 1 << static_cast<int>(std::log2(m_count)); stride > 0; stride >>= 1)
+    {
+        for (int idx = 0; idx < m_count; idx += stride)
+        {
+            if (!added.testBit(idx))
+            {
+                added.setBit(idx);
+                order.push_back(idx);
+            }
+        }
+    }
+
+    const int nThreads = qBound(1, QThread::idealThreadCount() / 2, 4);
+    std::vector<std::vector<int>> indexes(nThreads);
+    for (size_t i = 0; i < order.size(); ++i)
+        indexes[i % nThreads].push_back(order[i]);
+
+    for (auto &&threadIndexes : indexes)
+    {
+        if (threadIndexes.empty())
+            continue;
+        auto thr = std::make_unique<SeekPreviewThr>(m_url, m_interval, std::move(threadIndexes));
+        connect(thr.get(), SIGNAL(thumbnail(int, QImage)), this, SLOT(setThumbnail(int, QImage)));
+        connect(thr.get(), SIGNAL(finished()), this, SLOT(threadFinished()));
+        thr->start(QThread::LowestPriority);
+        m_threads.push_back(std::move(thr));
+    }
+}
+SeekPreview::~SeekPreview()
+{
+    for (auto &&thr : m_threads)
+    {
+        thr->disconnect(this);
+        thr->abort();
+    }
+}
+
+QImage SeekPreview::thumbnail(double pos) const
+{
+    if (m_sprite.isNull() || m_count <= 0)
+        return QImage();
+
+    const int idx = qBound(0, static_cast<int>(std::round(pos / m_interval)), m_count - 1);
+    for (int d = 0; d < m_count; ++d)
+    {
+        for (const int i : {idx - d, idx + d})
+        {
+            if (i < 0 || i >= m_count || !m_ready.testBit(i))
+                continue;
+            const QPoint topLeft((i % g_spriteColumns) * m_thumbnailSize.width(), (i / g_spriteColumns) * m_thumbnailSize.height());
+            return m_sprite.copy(QRect(topLeft, m_thumbnailSize));
+        }
+    }
+    return QImage();
+}
+
+bool SeekPreview::load()
+{
+    QFile f(m_cacheFile);
+    if (!f.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&f);
+    quint32 version = 0;
+    QByteArray spriteData;
+    stream >> version;
+    if (version != g_cacheVersion)
+        return false;
+    stream >> m_interval >> m_count >> m_thumbnailSize >> m_ready >> spriteData;
+    if (stream.status() != QDataStream::Ok || m_interval <= 0.0 || m_count != m_ready.size())
+        return false;
+
+    m_sprite = QImage::fromData(spriteData, "JPG").convertToFormat(QImage::Format_RGB32);
+    if (m_sprite.isNull())
+        return false;
+
+    // The modification time is the last access time for the eviction
+    f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+void SeekPreview::save() const
+{
+    QByteArray spriteData;
+    QBuffer buffer(&spriteData);
+    buffer.open(QBuffer::WriteOnly);
+    if (!m_sprite.save(&buffer, "JPG", 80))
+        return;
+
+    const QString dir = QFileInfo(m_cacheFile).path();
+    QDir().mkpath(dir);
+
+    QSaveFile f(m_cacheFile);
+    if (!f.open(QFile::WriteOnly))
+        return;
+
+    QDataStream stream(&f);
+    stream << g_cacheVersion << m_interval << m_count << m_thumbnailSize << m_ready << spriteData;
+    if (stream.status() != QDataStream::Ok || !f.commit())
+        return;
+
+    Functions::evictOldFiles(dir, g_maxCacheSize);
+}
+
+void SeekPreview::setThumbnail(int idx, const QImage &img)
+{
+    if (idx < 0 || idx >= m_count)
+        return;
+
+    if (m_sprite.isNull())
+    {
+        m_thumbnailSize = img.size();
+        const int rows = (m_count + g_spriteColumns - 1) / g_spriteColumns;
+        m_sprite = QImage(m_thumbnailSize.width() * g_spriteColumns, m_thumbnailSize.height() * rows, QImage::Format_RGB32);
+        m_sprite.fill(Qt::black);
+    }
+
+    const QRect rect(QPoint((idx % g_spriteColumns) * m_thumbnailSize.width(), (idx / g_spriteColumns) * m_thumbnailSize.height()), m_thumbnailSize);
+    QPainter(&m_sprite).drawImage(rect, img);
+    m_ready.setBit(idx);
+}
+void SeekPreview::threadFinished()
+{
+    bool completed = true;
+    for (auto &&thr : m_threads)
+    {
+        if (!thr->isFinished())
+            return;
+        if (!thr->isCompleted())
+            completed = false;
+    }
+    // Don't cache partial sprites, they would never be completed
+    if (completed && !m_sprite.isNull())
+        save();
+}
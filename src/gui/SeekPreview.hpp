@@ -0,0 +1,99 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <IOController.hpp>
+
+#include <QBitArray>
+#include <QThread>
+#include <QImage>
+
+#include <memory>
+#include <vector>
+
+class Demuxer;
+
+class SeekPreviewThr final : public QThread
+{
+    Q_OBJECT
+
+public:
+    SeekPreviewThr(const QString &url, double interval, std::vector<int> &&indexes);
+    ~SeekPreviewThr();
+
+    void abort();
+
+    // All thumbnails were processed, i.e. not aborted and no fatal error
+    inline bool isCompleted() const
+    {
+        return m_completed;
+    }
+
+private:
+    void run() override;
+
+private:
+    const QString m_url;
+    const double m_interval;
+    const std::vector<int> m_indexes;
+
+    IOController<Demuxer> m_demuxer;
+    bool m_completed = false;
+
+signals:
+    void thumbnail(int idx, const QImage &img);
+};
+
+/* Key frame thumbnails sprite for seek slider previews */
+class SeekPreview final : public QObject
+{
+    Q_OBJECT
+
+public:
+    SeekPreview(const QString &url, double length);
+    ~SeekPreview();
+
+    inline QString url() const
+    {
+        return m_url;
+    }
+
+    QImage thumbnail(double pos) const;
+
+private:
+    bool load();
+    void save() const;
+
+private slots:
+    void setThumbnail(int idx, const QImage &img);
+    void threadFinished();
+
+private:
+    const QString m_url;
+    const QString m_cacheFile;
+
+    double m_interval = 0.0;
+    int m_count = 0;
+
+    QSize m_thumbnailSize;
+    QImage m_sprite;
+    QBitArray m_ready;
+
+    std::vector<std::unique_ptr<SeekPreviewThr>> m_threads;
+};
@@ -236,9 +236,12 @@ void SettingsWidget::InitSettings()
     QMPSettings.init("AVBufferLocal", 100);
     QMPSettings.init("AVBufferTimeNetwork", 500.0);
     QMPSettings.init("BackwardBuffer", 1);
+    QMPSettings.init("TimeshiftSize", 0);
     QMPSettings.init("AVBufferTimeNetworkLive", 5.0);
     QMPSettings.init("PlayIfBuffered", 1.75);
     QMPSettings.init("MaxVol", 100);
+    QMPSettings.init("DecodeAheadFrames", 0);
+    QMPSettings.init("DecodeAheadMemory", 256);
     QMPSettings.init("VolumeL", 100);
     QMPSettings.init("VolumeR", 100);
     QMPSettings.init("ForceSamplerate", false);
@@ -251,6 +254,7 @@ void SettingsWidget::InitSettings()
     QMPSettings.init("ReplayGain/PreventClipping", true);
     QMPSettings.init("ReplayGain/Preamp", 0.0);
     QMPSettings.init("ShowBufferedTimeOnSlider", true);
+    QMPSettings.init("SeekPreview", true);
     QMPSettings.init("WheelAction", true);
     QMPSettings.init("WheelSeek", true);
     QMPSettings.init("LeftMouseTogglePlay", static_cast<int>(0));
@@ -260,6 +264,7 @@ void SettingsWidget::InitSettings()
     QMPSettings.init("RestoreAVSState", false);
     QMPSettings.init("DisableSubtitlesAtStartup", false);
     QMPSettings.init("StoreUrlPos", true);
+    QMPSettings.init("PrefetchNextEntry", true);
     QMPSettings.init("StoreARatioAndZoom", false);
     QMPSettings.init("SavePos", false);
     QMPSettings.init("KeepZoom", false);
@@ -592,8 +597,10 @@ SettingsWidget::SettingsWidget(int page, const QString &moduleName, QWidget *vid
         appendColon(playbackSettingsPage->bufferLocalL);
         appendColon(playbackSettingsPage->bufferNetworkL);
         appendColon(playbackSettingsPage->backwardBufferNetworkL);
+        appendColon(playbackSettingsPage->timeshiftL);
         appendColon(playbackSettingsPage->playIfBufferedL);
         appendColon(playbackSettingsPage->maxVolL);
+        appendColon(playbackSettingsPage->decodeAheadL);
         appendColon(playbackSettingsPage->forceSamplerate);
         appendColon(playbackSettingsPage->forceChannels);
 
@@ -602,6 +609,9 @@ SettingsWidget::SettingsWidget(int page, const QString &moduleName, QWidget *vid
         playbackSettingsPage->bufferNetworkB->setSuffix(" " + playbackSettingsPage->bufferNetworkB->suffix());
         playbackSettingsPage->playIfBufferedB->setSuffix(" " + playbackSettingsPage->playIfBufferedB->suffix());
         playbackSettingsPage->bufferLiveB->setSuffix(" " + playbackSettingsPage->bufferLiveB->suffix());
+        playbackSettingsPage->timeshiftB->setSuffix(" " + playbackSettingsPage->timeshiftB->suffix());
+        playbackSettingsPage->decodeAheadB->setToolTip(tr("Software decoded video frames are decoded in a separate thread ahead of their presentation time, so decoding spikes don't cause frame drops. It uses more memory."));
+        playbackSettingsPage->timeshiftB->setToolTip(tr("Older packets of network streams are stored on disk, so it is possible to seek backwards without reconnecting"));
         playbackSettingsPage->replayGainPreamp->setPrefix(playbackSettingsPage->replayGainPreamp->prefix() + ": ");
         playbackSettingsPage->replayGainPreampNoMetadata->setPrefix(playbackSettingsPage->replayGainPreampNoMetadata->prefix() + ": ");
 
@@ -612,10 +622,12 @@ SettingsWidget::SettingsWidget(int page, const QString &moduleName, QWidget *vid
         playbackSettingsPage->bufferLocalB->setValue(QMPSettings.getInt("AVBufferLocal"));
         playbackSettingsPage->bufferNetworkB->setValue(QMPSettings.getDouble("AVBufferTimeNetwork"));
         playbackSettingsPage->backwardBufferNetworkB->setCurrentIndex(QMPSettings.getUInt("BackwardBuffer"));
+        playbackSettingsPage->timeshiftB->setValue(QMPSettings.getInt("TimeshiftSize"));
         playbackSettingsPage->bufferLiveB->setValue(QMPSettings.getDouble("AVBufferTimeNetworkLive"));
         playbackSettingsPage->desiredVideoHeightB->setCurrentIndex(getDesiredVideoHeightIndex());
         playbackSettingsPage->playIfBufferedB->setValue(QMPSettings.getDouble("PlayIfBuffered"));
         playbackSettingsPage->maxVolB->setValue(QMPSettings.getInt("MaxVol"));
+        playbackSettingsPage->decodeAheadB->setValue(QMPSettings.getInt("DecodeAheadFrames"));
 
         playbackSettingsPage->forceSamplerate->setChecked(QMPSettings.getBool("ForceSamplerate"));
         playbackSettingsPage->samplerateB->setValue(QMPSettings.getInt("Samplerate"));
@@ -668,6 +680,7 @@ SettingsWidget::SettingsWidget(int page, const QString &moduleName, QWidget *vid
         });
 
         playbackSettingsPage->showBufferedTimeOnSlider->setChecked(QMPSettings.getBool("ShowBufferedTimeOnSlider"));
+        playbackSettingsPage->seekPreviewB->setChecked(QMPSettings.getBool("SeekPreview"));
         playbackSettingsPage->savePos->setChecked(QMPSettings.getBool("SavePos"));
         playbackSettingsPage->keepSubtitlesDelay->setChecked(QMPSettings.getBool("KeepSubtitlesDelay"));
         playbackSettingsPage->keepSubtitlesScale->setChecked(QMPSettings.getBool("KeepSubtitlesScale"));
@@ -690,6 +703,8 @@ SettingsWidget::SettingsWidget(int page, const QString &moduleName, QWidget *vid
 
         playbackSettingsPage->storeUrlPosB->setChecked(QMPSettings.getBool("StoreUrlPos"));
 
+        playbackSettingsPage->prefetchNextEntryB->setChecked(QMPSettings.getBool("PrefetchNextEntry"));
+
         for (int m = 1; m < 3; ++m)
             playbackSettingsPage->modulesListLayout->addWidget(m_modulesListGroupBox[m]);
     }
@@ -1411,12 +1426,14 @@ void SettingsWidget::apply()
             QMPSettings.set("AVBufferLocal", playbackSettingsPage->bufferLocalB->value());
             QMPSettings.set("AVBufferTimeNetwork", playbackSettingsPage->bufferNetworkB->value());
             QMPSettings.set("BackwardBuffer", playbackSettingsPage->backwardBufferNetworkB->currentIndex());
+            QMPSettings.set("TimeshiftSize", playbackSettingsPage->timeshiftB->value());
             QMPSettings.set("AVBufferTimeNetworkLive", playbackSettingsPage->bufferLiveB->value());
             QMPSettings.set("PlayIfBuffered", playbackSettingsPage->playIfBufferedB->value());
             QMPSettings.set("DesiredVideoHeight", getDesiredVideoHeight());
             QMPSettings.set("ForceSamplerate", playbackSettingsPage->forceSamplerate->isChecked());
             QMPSettings.set("Samplerate", playbackSettingsPage->samplerateB->value());
             QMPSettings.set("MaxVol", playbackSettingsPage->maxVolB->value());
+            QMPSettings.set("DecodeAheadFrames", playbackSettingsPage->decodeAheadB->value());
             QMPSettings.set("ForceChannels", playbackSettingsPage->forceChannels->checkState());
             QMPSettings.set("Channels", playbackSettingsPage->channelsB->value());
             QMPSettings.set("ResamplerFirst", playbackSettingsPage->resamplerFirst->isChecked());
@@ -1429,6 +1446,7 @@ void SettingsWidget::apply()
             QMPSettings.set("WheelSeek", playbackSettingsPage->wheelSeekB->isChecked());
             QMPSettings.set("WheelVolume", playbackSettingsPage->wheelVolumeB->isChecked());
             QMPSettings.set("ShowBufferedTimeOnSlider", playbackSettingsPage->showBufferedTimeOnSlider->isChecked());
+            QMPSettings.set("SeekPreview", playbackSettingsPage->seekPreviewB->isChecked());
             QMPSettings.set("SavePos", playbackSettingsPage->savePos->isChecked());
             QMPSettings.set("KeepZoom", playbackSettingsPage->keepZoom->isChecked());
             QMPSettings.set("KeepARatio", playbackSettingsPage->keepARatio->isChecked());
@@ -1447,6 +1465,7 @@ void SettingsWidget::apply()
             QMPSettings.set("RestoreAVSState", playbackSettingsPage->restoreAVSStateB->isChecked());
             QMPSettings.set("DisableSubtitlesAtStartup", playbackSettingsPage->disableSubtitlesAtStartup->isChecked());
             QMPSettings.set("StoreUrlPos", playbackSettingsPage->storeUrlPosB->isChecked());
+            QMPSettings.set("PrefetchNextEntry", playbackSettingsPage->prefetchNextEntryB->isChecked());
             QMPSettings.set("StoreARatioAndZoom", playbackSettingsPage->storeARatioAndZoomB->isChecked());
 
             QStringList audioWriters, decoders;
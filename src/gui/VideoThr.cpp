@@ -19,6 +19,7 @@
 #include <VideoThr.hpp>
 
 #include <VideoAdjustmentW.hpp>
+#include <DecodeAheadThr.hpp>
 #include <ScreenSaver.hpp>
 #include <PlayClass.hpp>
 #include <Main.hpp>
@@ -39,6 +40,7 @@
 #ifdef USE_VULKAN
 #   include <vulkan/VulkanInstance.hpp>
 #   include <vulkan/VulkanHWInterop.hpp>
+#   include <vulkan/VulkanSimpleDeint.hpp>
 #   include <vulkan/VulkanYadifDeint.hpp>
 #endif
 
@@ -78,6 +80,10 @@ VideoThr::VideoThr(PlayClass &playC, const QStringList &pluginsName) :
         writer = Writer::create("video:", pluginsName);
     }
 
+    const int decodeAheadFrames = QMPlay2Core.getSettings().getInt("DecodeAheadFrames");
+    if (writer && decodeAheadFrames > 0)
+        m_decodeAhead = make_unique<DecodeAheadThr>(*this, playC, decodeAheadFrames, QMPlay2Core.getSettings().getInt("DecodeAheadMemory") * 1048576LL);
+
     maybeStartThread();
 }
 VideoThr::~VideoThr()
@@ -96,6 +102,12 @@ void VideoThr::setDec(Decoder *dec)
     AVThread::setDec(dec);
     if (!dec->hasHWDecContext() && videoWriter()->hwDecContext())
         videoWriter()->setHWDecContext(nullptr);
+    if (m_decodeAhead)
+    {
+        // Hardware decoders have their own surface pools which can't be held in advance
+        m_decodeAhead->clear();
+        m_decodeAhead->setEnabled(!dec->hasHWDecContext());
+    }
     decoderError = false;
 }
 
@@ -117,7 +129,17 @@ bool VideoThr::lock()
     {
         m_subsDisplayLocker = {};
     }
-    return AVThread::lock();
+    if (!AVThread::lock())
+        return false;
+    if (m_decodeAhead)
+        m_decodeAhead->setLocked(true);
+    return true;
+}
+void VideoThr::unlock()
+{
+    if (m_decodeAhead)
+        m_decodeAhead->setLocked(false);
+    AVThread::unlock();
 }
 
 void VideoThr::stop(bool terminate)
@@ -126,6 +148,8 @@ void VideoThr::stop(bool terminate)
         QMPlay2Core.gpuInstance()->clearVideoOutput();
     playC.videoSeekPos = -1;
     AVThread::stop(terminate);
+    if (terminate)
+        m_decodeAhead.reset();
 }
 
 bool VideoThr::hasError() const
@@ -139,7 +163,11 @@ bool VideoThr::hasDecoderError() const
 
 AVPixelFormats VideoThr::getSupportedPixelFormats() const
 {
-    return videoWriter()->supportedPixelFormats();
+    const auto pixelFormats = videoWriter()->supportedPixelFormats();
+    if (getHWDecContext())
+        return pixelFormats;
+    // Prefer formats which all enabled CPU filters can process, so frames aren't passed through unfiltered
+    return filters.supportedPixelFormats(pixelFormats);
 }
 
 void VideoThr::setTsDiscontPossible(bool tsDiscontPossible)
@@ -257,9 +285,22 @@ void VideoThr::initFilters()
             if (!static_pointer_cast<QmVk::Instance>(QMPlay2Core.gpuInstance())->checkFiltersSupported())
                 return false;
 
-            shared_ptr<VideoFilter> deintFilter = make_shared<QmVk::YadifDeint>(
-                static_pointer_cast<QmVk::HWInterop>(getHWDecContext())
-            );
+            auto vkHwInterop = static_pointer_cast<QmVk::HWInterop>(getHWDecContext());
+
+            // Use the same method as software deinterlacing if it has a compute shader port,
+            // fall back to Yadif if the shader is not bundled (e.g. built without "glslc")
+            shared_ptr<VideoFilter> deintFilter;
+            QmVk::SimpleDeint::Method method;
+            if (QmVk::SimpleDeint::getMethod(QMPSettings.getString("Deinterlace/SoftwareMethod"), method)
+                    && (method == QmVk::SimpleDeint::Method::Bob) == doubleFramerate
+                    && QmVk::Instance::hasShader("deint.comp"))
+            {
+                deintFilter = make_shared<QmVk::SimpleDeint>(vkHwInterop, method);
+            }
+            else
+            {
+                deintFilter = make_shared<QmVk::YadifDeint>(vkHwInterop);
+            }
             if (deintFilter->modParam("DeinterlaceFlags", deintFlags))
             {
                 deintFilter->modParam("W", W);
@@ -350,6 +391,17 @@ void VideoThr::initFilters()
         }
     }
 
+    // The new filters can process different formats, negotiate the decoder output format again.
+    // The decoder is used only with "filtersMutex" locked or by the decode-ahead thread.
+    if (dec && writer)
+    {
+        const AVPixelFormats pixelFormats = getSupportedPixelFormats();
+        if (m_decodeAhead)
+            m_decodeAhead->setSupportedPixelFormats(pixelFormats);
+        else
+            dec->setSupportedPixelFormats(pixelFormats);
+    }
+
     filtersMutex.unlock();
     filters.start();
 }
@@ -430,9 +482,10 @@ void VideoThr::run()
             doScreenshot = false;
         }
 
+        const bool decodeAhead = (m_decodeAhead && m_decodeAhead->isEnabled());
         const bool mustFetchNewPacket = !filters.readyRead();
         playC.vPackets.lock();
-        const bool hasVPackets = playC.vPackets.canFetch();
+        const bool hasVPackets = playC.vPackets.canFetch() || (decodeAhead && m_decodeAhead->hasFrames());
         if (maybeFlush || (!gotFrameOrError && !err && mustFetchNewPacket))
             maybeFlush = playC.endOfStream && !hasVPackets;
         err = false;
@@ -462,9 +515,12 @@ void VideoThr::run()
         }
         paused = waiting = false;
 
+        // Flushing, accurate seeking and skipping to a key frame need the decoder on this thread
+        const bool syncDecode = (!decodeAhead || playC.flushVideo || skipNonKey || playC.videoSeekPos > 0.0 || maybeFlush);
+
         Packet packet;
         double ts = qQNaN();
-        if (hasVPackets && mustFetchNewPacket)
+        if (syncDecode && playC.vPackets.canFetch() && mustFetchNewPacket)
         {
             packet = playC.vPackets.fetch();
             if (packet.isTsValid())
@@ -502,11 +558,34 @@ void VideoThr::run()
                 frame_timer = -1.0;
         }
 
-        if ((!packet.isEmpty() || maybeFlush) && (!skipNonKey || packet.hasKeyFrame()))
+        DecodeAheadThr::Decoded decodedAhead;
+        bool hasDecodedAhead = false;
+        if (decodeAhead)
+        {
+            m_decodeAhead->setSyncDecoding(syncDecode || flushVideo);
+            if (flushVideo || skipNonKey)
+                m_decodeAhead->clear();
+            else if (mustFetchNewPacket && packet.isEmpty())
+                hasDecodedAhead = m_decodeAhead->take(decodedAhead);
+            if (!hasDecodedAhead && !syncDecode && !flushVideo && mustFetchNewPacket)
+                m_decodeAhead->waitForFrame(10);
+        }
+
+        if (hasDecodedAhead || ((!packet.isEmpty() || maybeFlush) && (!skipNonKey || packet.hasKeyFrame())))
         {
             Frame decoded;
             AVPixelFormat newPixelFormat = AV_PIX_FMT_NONE;
-            const int bytes_consumed = dec->decodeVideo(packet, decoded, newPixelFormat, flushVideo || skipNonKey, (skip && !skipNonKey) ? ~0 : (fast >> 1));
+            int bytes_consumed;
+            if (hasDecodedAhead)
+            {
+                decoded = move(decodedAhead.frame);
+                newPixelFormat = decodedAhead.newPixelFormat;
+                bytes_consumed = decodedAhead.bytesConsumed;
+            }
+            else
+            {
+                bytes_consumed = dec->decodeVideo(packet, decoded, newPixelFormat, flushVideo || skipNonKey, (skip && !skipNonKey) ? ~0 : (fast >> 1));
+            }
             ts = decoded.isTsValid() ? decoded.ts() : qQNaN();
             if (newPixelFormat != AV_PIX_FMT_NONE)
                 emit playC.pixelFormatUpdate(newPixelFormat);
@@ -877,6 +956,7 @@ void VideoThr::write(const Frame &videoFrame, QMPlay2OSDList &&osdList, quint32
 #endif
 
     videoWriter()->writeVideo(videoFrame, move(osdList));
+    playC.stopTransitionTimer();
 
     if (m_subsDisplayLocker.owns_lock())
         swap(m_subtitles, m_subtitlesBusy);
@@ -26,6 +26,7 @@ extern "C" {
     #include <libavutil/rational.h>
 }
 
+class DecodeAheadThr;
 class VideoWriter;
 class HWDecContext;
 
@@ -44,6 +45,7 @@ public:
     bool videoWriterSet();
 
     bool lock() override;
+    void unlock() override;
 
     void stop(bool terminate = false) override;
 
@@ -106,6 +108,7 @@ private:
 
     Decoder *sDec;
     bool m_decodeToAss = false;
+    std::unique_ptr<DecodeAheadThr> m_decodeAhead;
     std::shared_ptr<QMPlay2OSD> m_subtitles, m_subtitlesBusy;
     std::mutex m_subsDisplayMutex;
     std::unique_lock<std::mutex> m_subsDisplayLocker;
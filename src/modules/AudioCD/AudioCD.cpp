@@ -39,6 +39,7 @@ AudioCD::AudioCD() :
 
     init("AudioCD/CDDB", true);
     init("AudioCD/CDTEXT", true);
+    init("AudioCD/FastRead", false);
 }
 AudioCD::~AudioCD()
 {
@@ -122,7 +123,7 @@ void AudioCD::add()
 void AudioCD::browseCDImage()
 {
     QWidget *parent = (QWidget *)sender()->parent();
-    QString path = QFileDialog::getOpenFileName(parent, tr("Choose AudioCD image"), QString(), tr("Supported AudioCD images") + " (*.cue *.nrg *.toc)");
+    QString path = QFileDialog::getOpenFileName(parent, tr("Choose AudioCD image"), QString(), tr("Supported AudioCD images") + " (*.cue *.bin *.nrg *.toc)");
     if (!path.isEmpty())
     {
         QComboBox &drvB = *parent->findChild<QComboBox *>();
@@ -150,9 +151,13 @@ ModuleSettingsWidget::ModuleSettingsWidget(Module &module) :
     useCDTEXT = new QCheckBox(tr("Use CD-TEXT"));
     useCDTEXT->setChecked(sets().getBool("AudioCD/CDTEXT"));
 
+    fastRead = new QCheckBox(tr("Read the disc at full speed"));
+    fastRead->setChecked(sets().getBool("AudioCD/FastRead"));
+
     QVBoxLayout *audioCDBLayout = new QVBoxLayout(audioCDB);
     audioCDBLayout->addWidget(useCDDB);
     audioCDBLayout->addWidget(useCDTEXT);
+    audioCDBLayout->addWidget(fastRead);
 
     QGridLayout *layout = new QGridLayout(this);
     layout->addWidget(audioCDB);
@@ -162,4 +167,5 @@ void ModuleSettingsWidget::saveSettings()
 {
     sets().set("AudioCD/CDDB", useCDDB->isChecked());
     sets().set("AudioCD/CDTEXT", useCDTEXT->isChecked());
+    sets().set("AudioCD/FastRead", fastRead->isChecked());
 }
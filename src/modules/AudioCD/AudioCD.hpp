@@ -61,5 +61,5 @@ private:
     void saveSettings() override;
 
     QGroupBox *audioCDB;
-    QCheckBox *useCDDB, *useCDTEXT;
+    QCheckBox *useCDDB, *useCDTEXT, *fastRead;
 };
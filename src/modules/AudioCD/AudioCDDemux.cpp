@@ -17,10 +17,13 @@
 */
 
 #include <AudioCDDemux.hpp>
+#include <CDReadAhead.hpp>
 
 #include <Functions.hpp>
 #include <Packet.hpp>
 
+#include <QFileInfo>
+
 #ifdef Q_OS_WIN
     #include <QRegularExpression>
     #include <QDir>
@@ -95,6 +98,19 @@ QStringList AudioCDDemux::getDevices()
     }
     return devicesList;
 }
+CdIo_t *AudioCDDemux::openDevice(const QString &device)
+{
+    // Disc images go straight to the libcdio image drivers
+    driver_id_t driverId = DRIVER_UNKNOWN;
+    const QString suffix = QFileInfo(device).suffix().toLower();
+    if (suffix == "cue" || suffix == "bin")
+        driverId = DRIVER_BINCUE;
+    else if (suffix == "nrg")
+        driverId = DRIVER_NRG;
+    else if (suffix == "toc")
+        driverId = DRIVER_CDRDAO;
+    return cdio_open(device.toLocal8Bit(), driverId);
+}
 
 AudioCDDemux::AudioCDDemux(Module &module, CDIODestroyTimer &destroyTimer) :
     destroyTimer(destroyTimer),
@@ -108,6 +124,7 @@ AudioCDDemux::AudioCDDemux(Module &module, CDIODestroyTimer &destroyTimer) :
 
 AudioCDDemux::~AudioCDDemux()
 {
+    readAhead.reset();
     if (cdio)
         emit destroyTimer.setInstance(cdio, device, discID);
 }
@@ -116,6 +133,7 @@ bool AudioCDDemux::set()
 {
     useCDDB   = sets().getBool("AudioCD/CDDB");
     useCDTEXT = sets().getBool("AudioCD/CDTEXT");
+    fastRead  = sets().getBool("AudioCD/FastRead");
     return true;
 }
 
@@ -172,11 +190,11 @@ bool AudioCDDemux::seek(double s, bool)
 }
 bool AudioCDDemux::read(Packet &decoded, int &idx)
 {
-    if (aborted || numSectors <= sector || isData)
+    if (aborted || numSectors <= sector || isData || !readAhead)
         return false;
 
-    short cd_samples[CD_BLOCKSIZE];
-    if (cdio_read_audio_sector(cdio, cd_samples, startSector + sector) == DRIVER_OP_SUCCESS)
+    qint16 cd_samples[CD_BLOCKSIZE];
+    if (readAhead->read(sector, cd_samples))
     {
         decoded.resize(CD_BLOCKSIZE * sizeof(float));
         float *decoded_data = (float *)decoded.data();
@@ -196,6 +214,8 @@ bool AudioCDDemux::read(Packet &decoded, int &idx)
 void AudioCDDemux::abort()
 {
     aborted = true;
+    if (readAhead)
+        readAhead->abort();
 }
 
 bool AudioCDDemux::open(const QString &_url)
@@ -226,9 +246,15 @@ bool AudioCDDemux::open(const QString &_url)
     if (trackNo > 0 && trackNo < CDIO_INVALID_TRACK)
     {
         cdio = destroyTimer.getInstance(device, discID);
-        if (cdio || (cdio = cdio_open(device.toLocal8Bit(), DRIVER_UNKNOWN)))
+        if (cdio || (cdio = openDevice(device)))
         {
-            cdio_set_speed(cdio, 1);
+            const driver_id_t driverId = cdio_get_driver_id(cdio);
+            if (driverId != DRIVER_BINCUE && driverId != DRIVER_NRG && driverId != DRIVER_CDRDAO)
+            {
+                // Read a bit faster than real time, so the read-ahead can stay ahead of playback.
+                // Speeds above the drive limit select its fastest speed.
+                cdio_set_speed(cdio, fastRead ? 100 : 2);
+            }
             numTracks = cdio_get_num_tracks(cdio);
             if (cdio_get_discmode(cdio) != CDIO_DISC_MODE_ERROR && numTracks > 0 && numTracks != CDIO_INVALID_TRACK)
             {
@@ -259,6 +285,9 @@ bool AudioCDDemux::open(const QString &_url)
                         }
                     }
 
+                    if (!isData)
+                        readAhead.reset(new CDReadAhead(cdio, startSector, numSectors));
+
                     streams_info += new StreamInfo(srate, chn);
                     return true;
                 }
@@ -433,8 +462,9 @@ Playlist::Entries AudioCDDemux::getTracks(const QString &_device)
     if (device.endsWith("/"))
         device.chop(1);
 #endif
-    cdio_close_tray(device.toLocal8Bit(), nullptr);
-    if ((cdio = cdio_open(device.toLocal8Bit(), DRIVER_UNKNOWN)))
+    if (!QFileInfo(device).isFile())
+        cdio_close_tray(device.toLocal8Bit(), nullptr);
+    if ((cdio = openDevice(device)))
     {
         numTracks = cdio_get_num_tracks(cdio);
         if (cdio_get_discmode(cdio) != CDIO_DISC_MODE_ERROR && numTracks > 0 && numTracks != CDIO_INVALID_TRACK)
@@ -26,6 +26,10 @@
 #include <cdio/cdio.h>
 #include <cddb/cddb.h>
 
+#include <memory>
+
+class CDReadAhead;
+
 class CDIODestroyTimer final : public QObject
 {
     Q_OBJECT
@@ -53,6 +57,7 @@ class AudioCDDemux final : public Demuxer
     Q_DECLARE_TR_FUNCTIONS(AudioCDDemux)
 public:
     static QStringList getDevices();
+    static CdIo_t *openDevice(const QString &device);
 
     AudioCDDemux(Module &, CDIODestroyTimer &destroyTimer);
 private:
@@ -88,10 +93,11 @@ private:
 
     QString Title, Artist, Genre, cdTitle, cdArtist, device;
     CdIo_t *cdio;
+    std::unique_ptr<CDReadAhead> readAhead;
     track_t trackNo, numTracks;
     lsn_t startSector, numSectors, sector;
     double duration;
-    bool isData, aborted, useCDDB, useCDTEXT;
+    bool isData, aborted, useCDDB, useCDTEXT, fastRead;
     unsigned char chn;
     unsigned discID;
 };
@@ -0,0 +1,147 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <CDReadAhead.hpp>
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstring>
+
+constexpr int g_sectorSamples = CDIO_CD_FRAMESIZE_RAW / sizeof(qint16);
+constexpr lsn_t g_batchSectors = 24; // Keeps a single read below 64 KiB
+constexpr lsn_t g_ringSectors = 75 * 10; // 10 seconds
+constexpr int g_maxReadRetries = 3;
+
+CDReadAhead::CDReadAhead(CdIo_t *cdio, lsn_t startSector, lsn_t numSectors)
+    : m_cdio(cdio)
+    , m_startSector(startSector)
+    , m_numSectors(numSectors)
+    , m_ring(g_ringSectors * g_sectorSamples)
+{
+    setObjectName("CDReadAhead");
+    start();
+}
+CDReadAhead::~CDReadAhead()
+{
+    abort();
+    wait();
+}
+
+bool CDReadAhead::read(lsn_t sector, qint16 *samples)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (sector < m_bufferBegin || sector > m_bufferEnd)
+    {
+        // Seek - drop the buffer and restart reading from the requested sector
+        m_bufferBegin = m_bufferEnd = sector;
+        m_failedReads = 0;
+        ++m_generation;
+        m_cond.wakeAll();
+    }
+    else if (sector > m_bufferBegin)
+    {
+        m_bufferBegin = sector;
+        m_cond.wakeAll();
+    }
+
+    while (!m_aborted && sector >= m_bufferEnd && sector < m_numSectors)
+        m_cond.wait(&m_mutex);
+
+    if (m_aborted || sector >= m_bufferEnd)
+        return false;
+
+    memcpy(samples, m_ring.data() + (sector % g_ringSectors) * g_sectorSamples, CDIO_CD_FRAMESIZE_RAW);
+
+    m_bufferBegin = sector + 1;
+    m_cond.wakeAll();
+
+    return true;
+}
+
+void CDReadAhead::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aborted = true;
+    m_cond.wakeAll();
+}
+
+void CDReadAhead::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_aborted)
+    {
+        const lsn_t buffered = m_bufferEnd - m_bufferBegin;
+        if (buffered >= g_ringSectors || m_bufferEnd >= m_numSectors)
+        {
+            m_cond.wait(&m_mutex);
+            continue;
+        }
+
+        const lsn_t sector = m_bufferEnd;
+        const lsn_t ringPos = sector % g_ringSectors;
+        const lsn_t count = std::min({
+            g_batchSectors,
+            g_ringSectors - buffered,
+            g_ringSectors - ringPos, // Don't wrap around within a single read
+            m_numSectors - sector,
+        });
+        const quint32 generation = m_generation;
+
+        // Slots past "m_bufferEnd" are never accessed by the reader, so fill them unlocked
+        locker.unlock();
+        const int sectorsRead = readSectors(sector, count, m_ring.data() + ringPos * g_sectorSamples);
+        locker.relock();
+
+        if (generation != m_generation)
+            continue; // Seeked while reading
+
+        m_bufferEnd += sectorsRead;
+        if (sectorsRead < count)
+        {
+            // The next loop iteration retries from the failed sector
+            if (++m_failedReads >= g_maxReadRetries)
+            {
+                // Unreadable sector - play silence instead and continue reading past it
+                memset(m_ring.data() + (m_bufferEnd % g_ringSectors) * g_sectorSamples, 0, CDIO_CD_FRAMESIZE_RAW);
+                ++m_bufferEnd;
+                m_failedReads = 0;
+            }
+        }
+        else
+        {
+            m_failedReads = 0;
+        }
+        m_cond.wakeAll();
+    }
+}
+
+int CDReadAhead::readSectors(lsn_t sector, int count, qint16 *samples)
+{
+    if (cdio_read_audio_sectors(m_cdio, samples, m_startSector + sector, count) == DRIVER_OP_SUCCESS)
+        return count;
+
+    // Some drives reject multi-sector reads, fall back to reading sector by sector
+    for (int i = 0; i < count; ++i)
+    {
+        if (cdio_read_audio_sector(m_cdio, samples + i * g_sectorSamples, m_startSector + sector + i) != DRIVER_OP_SUCCESS)
+            return i;
+    }
+    return count;
+}
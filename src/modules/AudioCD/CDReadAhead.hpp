@@ -0,0 +1,62 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QWaitCondition>
+#include <QThread>
+#include <QMutex>
+
+#include <cdio/cdio.h>
+
+#include <vector>
+
+/* Reads audio sectors in large batches ahead of the demuxer into a ring buffer */
+class CDReadAhead final : public QThread
+{
+public:
+    CDReadAhead(CdIo_t *cdio, lsn_t startSector, lsn_t numSectors);
+    ~CDReadAhead();
+
+    // Blocks until the sector (relative to the track start) is read, starts reading from it if not buffered
+    bool read(lsn_t sector, qint16 *samples);
+
+    void abort();
+
+private:
+    void run() override;
+
+    int readSectors(lsn_t sector, int count, qint16 *samples);
+
+private:
+    CdIo_t *const m_cdio;
+    const lsn_t m_startSector;
+    const lsn_t m_numSectors;
+
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+
+    std::vector<qint16> m_ring;
+
+    // Buffered range of sectors, "m_bufferEnd" is the next sector to read
+    lsn_t m_bufferBegin = 0;
+    lsn_t m_bufferEnd = 0;
+    int m_failedReads = 0; // Consecutive failed reads of "m_bufferEnd" sector
+    quint32 m_generation = 0;
+    bool m_aborted = false;
+};
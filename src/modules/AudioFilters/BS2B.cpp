@@ -57,9 +57,18 @@ double BS2B::filter(QByteArray &data, bool flush)
 {
     Q_UNUSED(flush)
     if (m_canFilter)
-        bs2b_cross_feed_f(m_bs2b, (float *)data.data(), data.size() / sizeof(float) / 2);
+        filterSamples((float *)data.data(), data.size() / sizeof(float));
     return 0.0;
 }
+bool BS2B::canBeFused() const
+{
+    return true;
+}
+void BS2B::filterSamples(float *samples, int size)
+{
+    if (m_canFilter)
+        bs2b_cross_feed_f(m_bs2b, samples, size / 2);
+}
 
 void BS2B::alloc()
 {
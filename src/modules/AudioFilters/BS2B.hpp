@@ -33,6 +33,8 @@ private:
     bool setAudioParameters(uchar, uint srate) override;
     void clearBuffers() override;
     double filter(QByteArray &data, bool flush) override;
+    bool canBeFused() const override;
+    void filterSamples(float *samples, int size) override;
 
     void alloc();
 
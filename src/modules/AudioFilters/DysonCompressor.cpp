@@ -74,6 +74,8 @@
 
 DysonCompressor::DysonCompressor(Module &module) :
     enabled(false),
+    mustClear(false),
+    paramsChanged(false),
     channels(0),
     sampleRate(0)
 {
@@ -88,21 +90,24 @@ bool DysonCompressor::set()
 
     const bool newEnabled = sets().getBool("Compressor");
 
-    peakpercent = sets().getInt("Compressor/PeakPercent");
-    releasetime = sets().getDouble("Compressor/ReleaseTime");
+    pendingParams.peakpercent = sets().getInt("Compressor/PeakPercent");
+    pendingParams.releasetime = sets().getDouble("Compressor/ReleaseTime");
 
     // Compression ratio for fast gain. This will determine how
     // much the audio is made more dense. 0.5 is equiv to 2:1
     // compression. 1.0 is equiv to inf:1 compression.
-    fastgaincompressionratio = sets().getDouble("Compressor/FastGainCompressionRatio");
+    pendingParams.fastgaincompressionratio = sets().getDouble("Compressor/FastGainCompressionRatio");
 
     // Overall ompression ratio.
-    compressionratio = sets().getDouble("Compressor/OverallCompressionRatio");
+    pendingParams.compressionratio = sets().getDouble("Compressor/OverallCompressionRatio");
+
+    paramsChanged = true;
 
     if (newEnabled != enabled)
     {
+        // Buffers are owned by the audio thread, they are cleared there
+        mustClear = true;
         enabled = newEnabled;
-        clearBuffers();
     }
 
     return true;
@@ -111,6 +116,8 @@ bool DysonCompressor::set()
 bool DysonCompressor::setAudioParameters(uchar chn, uint srate)
 {
     QMutexLocker locker(&mutex);
+    params = pendingParams;
+    paramsChanged = false;
     channels = chn;
     sampleRate = srate;
     clearBuffers();
@@ -118,10 +125,12 @@ bool DysonCompressor::setAudioParameters(uchar chn, uint srate)
 }
 int DysonCompressor::bufferedSamples() const
 {
-    return delayedSamples;
+    return enabled ? delayedSamples : 0;
 }
 void DysonCompressor::clearBuffers()
 {
+    mustClear = false;
+
     toRemove = NDELAY;
     delayedSamples = 0;
     ndelayptr = 0;
@@ -136,36 +145,45 @@ void DysonCompressor::clearBuffers()
     memset(rlevelsqn, 0, sizeof rlevelsqn);
     memset(rlevelsqe, 0, sizeof rlevelsqe);
 
-    samplesdelayed.clear();
-    if (enabled)
-    {
-        for (int i = 0; i < channels; ++i)
-            samplesdelayed.append(FloatVector(NDELAY));
-    }
+    samplesdelayed.fill(0.0f, NDELAY * channels);
 }
 double DysonCompressor::filter(QByteArray &data, bool flush)
 {
     if (!enabled)
         return 0.0;
 
-    QMutexLocker locker(&mutex);
+    // Never wait for the settings on the audio thread, pick them up on the next call if busy
+    if (paramsChanged && mutex.tryLock())
+    {
+        params = pendingParams;
+        paramsChanged = false;
+        mutex.unlock();
+    }
+    if (mustClear)
+        clearBuffers();
 
     if (!flush)
     {
         const int size = data.size() / sizeof(float);
         float *samples = (float *)data.data();
+        float *delayed = samplesdelayed.data();
+
+        const double targetlevel = MAXLEVEL * params.peakpercent / 100.0;
+        const double rgainfilter = 1.0 / (params.releasetime * sampleRate);
+        const double compressionratio = params.compressionratio;
+        const double fastgaincompressionratio = params.fastgaincompressionratio;
 
-        const double targetlevel = MAXLEVEL * peakpercent / 100.0;
-        const double rgainfilter = 1.0 / (releasetime * sampleRate);
+        QVarLengthArray<double, 8> newsample(channels);
 
         for (int pos = 0; pos < size; pos += channels)
         {
             float *currentsamples = samples + pos;
+            float *currentdelayed = delayed + ndelayptr * channels;
 
             double levelsq0 = 0.0;
             for (int c = 0; c < channels; ++c)
             {
-                samplesdelayed[c][ndelayptr] = currentsamples[c];
+                currentdelayed[c] = currentsamples[c];
                 levelsq0 += (double)currentsamples[c] * (double)currentsamples[c];
             }
 
@@ -223,9 +241,8 @@ double DysonCompressor::filter(QByteArray &data, bool flush)
                     lastrgain = gain;
             }
 
-            QVarLengthArray<float, 8> sampled(channels);
-            for (int c = 0; c < channels; ++c)
-                sampled[c] = samplesdelayed.at(c).at(ndelayptr);
+            // The oldest frame in the delay line
+            const float *sampled = delayed + ndelayptr * channels;
 
             double fastgain = lastrgain;
             if (fastgain > MAXFASTGAIN)
@@ -253,21 +270,16 @@ double DysonCompressor::filter(QByteArray &data, bool flush)
 
             const double npeakgain = rmastergain0 * qgain;
 
-            float ngain = MAXLEVEL;
-
-            QVarLengthArray<double, 8> newsample(channels);
+            // The peak limiter only depends on the loudest channel
+            double maxsample = 0.0;
             for (int c = 0; c < channels; ++c)
             {
                 newsample[c] = sampled[c] * npeakgain;
-
-                double tmpgain = 1.0;
-                if (fabs(newsample[c]) >= MAXLEVEL)
-                    tmpgain = MAXLEVEL / fabs(newsample[c]);
-
-                if (tmpgain < ngain)
-                    ngain = tmpgain;
+                maxsample = qMax(maxsample, fabs(newsample[c]));
             }
 
+            const float ngain = (maxsample >= MAXLEVEL) ? MAXLEVEL / maxsample : MAXLEVEL;
+
             const double ngsq = ngain * ngain;
             if (ngsq <= rpeakgain0)
             {
@@ -307,10 +319,10 @@ double DysonCompressor::filter(QByteArray &data, bool flush)
     {
         data.resize(channels * sizeof(float) * delayedSamples);
         float *samples = (float *)data.data();
+        const float *delayed = samplesdelayed.constData();
         for (int pos = 0; pos < delayedSamples; ++pos)
         {
-            for (int c = 0; c < channels; ++c)
-                samples[pos * channels + c] = samplesdelayed.at(c).at(ndelayptr);
+            memcpy(samples + pos * channels, delayed + ndelayptr * channels, channels * sizeof(float));
             if (++ndelayptr >= NDELAY)
                 ndelayptr = 0;
         }
@@ -20,8 +20,11 @@
 
 #include <AudioFilter.hpp>
 
+#include <QVector>
 #include <QMutex>
 
+#include <atomic>
+
 #define NFILT  12
 #define NEFILT 17
 
@@ -39,10 +42,17 @@ private:
     void clearBuffers() override;
     double filter(QByteArray &data, bool flush) override;
 
-    using FloatVector = QVector<float>;
+    struct Params
+    {
+        int peakpercent = 0;
+        double releasetime = 0.0;
+        double fastgaincompressionratio = 0.0, compressionratio = 0.0;
+    };
 
     QMutex mutex;
-    bool enabled;
+    std::atomic_bool enabled, mustClear, paramsChanged;
+    Params pendingParams; // Guarded by "mutex"
+    Params params;
 
     int channels, sampleRate;
     int toRemove, delayedSamples;
@@ -51,7 +61,7 @@ private:
     double rlevelsq0, rlevelsq1;
     double rlevelsqn[NFILT];
     double rlevelsqe[NEFILT];
-    QVector<FloatVector> samplesdelayed;
+    QVector<float> samplesdelayed; // Interleaved, "NDELAY" frames
     /* Simple gain running average */
     double rgain;
     double lastrgain;
@@ -60,10 +70,6 @@ private:
     /* Peak limit gain */
     double rpeakgain0, rpeakgain1;
     int peaklimitdelay, rpeaklimitdelay;
-
-    int peakpercent;
-    double releasetime;
-    double fastgaincompressionratio, compressionratio;
 };
 
 #define DysonCompressorName "DysonCompressor"
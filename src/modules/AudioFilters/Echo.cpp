@@ -55,14 +55,22 @@ bool Echo::setAudioParameters(uchar chn, uint srate)
     return hasParameters;
 }
 double Echo::filter(QByteArray &data, bool)
+{
+    if (canFilter)
+        filterSamples((float *)data.data(), data.size() / sizeof(float));
+    return 0.0;
+}
+bool Echo::canBeFused() const
+{
+    return true;
+}
+void Echo::filterSamples(float *samples, int size)
 {
     if (canFilter)
     {
-        const int size = data.size() / sizeof(float);
         const int sampleBufferSize = sampleBuffer.size();
         float *sampleBufferData = sampleBuffer.data();
         const int repeat_div = echo_surround ? 200 : 100;
-        float *samples = (float *)data.data();
         int r_ofs = w_ofs - (srate * echo_delay / 1000) * chn;
         if (r_ofs < 0)
             r_ofs += sampleBufferSize;
@@ -84,7 +92,6 @@ double Echo::filter(QByteArray &data, bool)
                 w_ofs -= sampleBufferSize;
         }
     }
-    return 0.0;
 }
 
 void Echo::alloc(bool b)
@@ -41,14 +41,20 @@ bool PhaseReverse::setAudioParameters(uchar chn, uint /*srate*/)
     return hasParameters;
 }
 double PhaseReverse::filter(QByteArray &data, bool)
+{
+    if (canFilter)
+        filterSamples((float *)data.data(), data.size() / sizeof(float));
+    return 0.0;
+}
+bool PhaseReverse::canBeFused() const
+{
+    return true;
+}
+void PhaseReverse::filterSamples(float *samples, int size)
 {
     if (canFilter)
     {
-        const int size = data.size() / sizeof(float);
-        float *samples = (float *)data.data();
-
         for (int i = reverseRight; i < size; i += chn)
             samples[i] = -samples[i];
     }
-    return 0.0;
 }
@@ -40,14 +40,20 @@ bool SwapStereo::setAudioParameters(uchar chn, uint srate)
     return m_hasParameters;
 }
 double SwapStereo::filter(QByteArray &data, bool)
+{
+    if (m_canFilter)
+        filterSamples((float *)data.data(), data.size() / sizeof(float));
+    return 0.0;
+}
+bool SwapStereo::canBeFused() const
+{
+    return true;
+}
+void SwapStereo::filterSamples(float *samples, int size)
 {
     if (m_canFilter)
     {
-        const int size = data.size() / sizeof(float);
-        float *samples = (float *)data.data();
-
         for (int i = 0; i < size; i += m_chn)
             qSwap(samples[i + 0], samples[i + 1]);
     }
-    return 0.0;
 }
@@ -40,14 +40,20 @@ bool VoiceRemoval::setAudioParameters(uchar chn, uint /*srate*/)
     return hasParameters;
 }
 double VoiceRemoval::filter(QByteArray &data, bool)
+{
+    if (canFilter)
+        filterSamples((float *)data.data(), data.size() / sizeof(float));
+    return 0.0;
+}
+bool VoiceRemoval::canBeFused() const
+{
+    return true;
+}
+void VoiceRemoval::filterSamples(float *samples, int size)
 {
     if (canFilter)
     {
-        const int size = data.size() / sizeof(float);
-        float *samples = (float *)data.data();
-
         for (int i = 0; i < size; i += chn)
             samples[i] = samples[i+1] = samples[i] - samples[i+1];
     }
-    return 0.0;
 }
@@ -29,6 +29,8 @@ public:
 private:
     bool setAudioParameters(uchar, uint) override;
     double filter(QByteArray &, bool) override;
+    bool canBeFused() const override;
+    void filterSamples(float *samples, int size) override;
 
     bool enabled, hasParameters, canFilter;
     uchar chn;
@@ -103,7 +103,7 @@ void LastFM::getAlbumCover(const QString &title, const QString &artist, const QS
             disconnect(coverReply, SIGNAL(finished()), this, SLOT(albumFinished()));
             coverReply->deleteLater();
         }
-        coverReply = net.start(url);
+        coverReply = net.start(url); // API response, the album info can change
         coverReply->setProperty("taa", QStringList {
             titleAsAlbum ? album : title,
             artist,
@@ -301,7 +301,7 @@ void LastFM::albumFinished()
                         if (imgUrl.contains("noimage"))
                             continue;
                         coverReply->deleteLater();
-                        coverReply = net.start(imgUrl);
+                        coverReply = net.startCached(imgUrl);
                         coverReply->setProperty("taa", taa);
                         coverReply->setProperty("origTitle", origTitle);
                         connect(coverReply, SIGNAL(finished()), this, SLOT(albumFinished()));
@@ -87,7 +87,7 @@ void RadioBrowserModel::loadIcons(const int first, const int last)
         Column *column = m_rowsToDisplay[i].get();
         if (!column->iconReply && !column->iconUrl.isEmpty())
         {
-            column->iconReply = m_net->start(column->iconUrl);
+            column->iconReply = m_net->startCached(column->iconUrl);
             for (const std::shared_ptr<Column> &c : std::as_const(m_rows))
             {
                 if (c.get() == column)
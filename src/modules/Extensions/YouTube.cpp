@@ -965,7 +965,8 @@ void YouTube::setSearchResults(const QJsonObject &jsonObj, bool isContinuation,
 
         if (!thumbnail.isEmpty())
         {
-            auto imageReply = net.start(thumbnail);
+            auto imageReply = net.startCached(thumbnail);
+            imageReply->setPriority(-1); // Don't delay search and playback requests
             imageReply->setProperty("tWI", QVariant::fromValue((void *)tWI));
             imageReplies += imageReply;
         }
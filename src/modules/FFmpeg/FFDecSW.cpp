@@ -17,6 +17,7 @@
 */
 
 #include <FFDecSW.hpp>
+#include <SwsConvertThr.hpp>
 #include <FFCommon.hpp>
 
 #include <QMPlay2OSD.hpp>
@@ -24,6 +25,12 @@
 #include <StreamInfo.hpp>
 #include <Functions.hpp>
 
+#include <QThread>
+#include <QDebug>
+
+#include <atomic>
+#include <cmath>
+
 #ifdef USE_VULKAN
 #   include "../qmvk/MemoryPropertyFlags.hpp"
 #   include "../qmvk/PhysicalDevice.hpp"
@@ -46,6 +53,61 @@ extern "C"
 
 using namespace std;
 
+// Number of software video decoders currently opened (playback, seek previews, etc.)
+static atomic_int g_openVideoDecoders {0};
+
+static int getAutoThreadCount(const AVCodecContext *codecCtx, int otherDecoders)
+{
+    // Pick the thread count from the amount of work per frame, more threads only add latency and memory
+    const qint64 pixels = qint64(codecCtx->width) * codecCtx->height;
+    int threads;
+    if (pixels <= 0)
+        threads = 4; // Unknown size
+    else if (pixels <= 640 * 480)
+        threads = 2;
+    else if (pixels <= 1280 * 720)
+        threads = 3;
+    else if (pixels <= 1920 * 1080)
+        threads = 4;
+    else if (pixels <= 2560 * 1440)
+        threads = 6;
+    else if (pixels <= 3840 * 2160)
+        threads = 8;
+    else
+        threads = 12;
+
+    const AVPixFmtDescriptor *pixDesc = av_pix_fmt_desc_get(codecCtx->pix_fmt);
+    if ((pixDesc && pixDesc->comp[0].depth > 8) || codecCtx->bits_per_raw_sample > 8)
+        threads += threads / 2; // High bit depth
+    if (pixDesc && pixDesc->nb_components >= 3 && pixDesc->log2_chroma_w == 0 && pixDesc->log2_chroma_h == 0)
+        threads += threads / 2; // 4:4:4 profiles, full resolution chroma
+
+    switch (codecCtx->codec_id)
+    {
+        case AV_CODEC_ID_MPEG1VIDEO:
+        case AV_CODEC_ID_MPEG2VIDEO:
+        case AV_CODEC_ID_MPEG4:
+        case AV_CODEC_ID_H263:
+        case AV_CODEC_ID_MJPEG:
+        case AV_CODEC_ID_VP8:
+            // Cheap to decode, half of the threads is enough
+            threads = (threads + 1) / 2;
+            break;
+        case AV_CODEC_ID_HEVC:
+        case AV_CODEC_ID_VP9:
+        case AV_CODEC_ID_AV1:
+            // Expensive to decode
+            threads += threads / 4;
+            break;
+        default:
+            break;
+    }
+
+    // Share the CPU with other decoders
+    const int cpus = qMax(1, QThread::idealThreadCount());
+    return qBound(1, threads, qMax(1, cpus / (otherDecoders + 1)));
+}
+
 Subtitle::Subtitle()
 {
     memset(av(), 0, sizeof(AVSubtitle));
@@ -72,15 +134,28 @@ double Subtitle::duration() const
 
 FFDecSW::FFDecSW(Module &module) :
     threads(0), lowres(0),
-    thread_type_slice(false),
-    lastFrameW(-1), lastFrameH(-1),
-    sws_ctx(nullptr)
+    thread_type_slice(false)
 {
     SetModule(module);
 }
 FFDecSW::~FFDecSW()
 {
-    sws_freeContext(sws_ctx);
+    if (m_countedAsVideoDecoder)
+        --g_openVideoDecoders;
+    if (m_swsConvertThr)
+    {
+        m_swsConvertThr->clear();
+        const int convertedFrames = m_swsConvertThr->convertedFrames();
+        if (convertedFrames > 0 && m_decodedFrames > 0)
+        {
+            qDebug().nospace()
+                << "FFDecSW: decoding " << m_decodeTime * 1000.0 / m_decodedFrames << " ms/frame, "
+                << "conversion " << m_swsConvertThr->convertTime() * 1000.0 / convertedFrames << " ms/frame, "
+                << "waiting for conversion " << m_swsConvertThr->waitTime() * 1000.0 / convertedFrames << " ms/frame "
+                << "(" << convertedFrames << " frames)"
+            ;
+        }
+    }
 }
 
 bool FFDecSW::set()
@@ -111,7 +186,7 @@ bool FFDecSW::set()
 
     int _threads = sets().getInt("Threads");
     if (_threads < 0)
-        _threads = 0; //Autodetect by FFmpeg
+        _threads = 0; //Autodetect per stream
     else if (_threads > 16)
         _threads = 16;
     if (threads != _threads)
@@ -154,6 +229,11 @@ QByteArray FFDecSW::subtitleHeader() const
     return QByteArray::fromRawData(reinterpret_cast<const char *>(codec_ctx->subtitle_header), codec_ctx->subtitle_header_size);
 }
 
+int FFDecSW::pendingFrames() const
+{
+    return FFDec::pendingFrames() + ((m_swsConvertThr && m_swsConvertThr->hasPending()) ? 1 : 0);
+}
+
 void FFDecSW::setSupportedPixelFormats(const AVPixelFormats &pixelFormats)
 {
     FFDec::setSupportedPixelFormats(pixelFormats);
@@ -286,6 +366,8 @@ int FFDecSW::decodeVideo(const Packet &encodedPacket, Frame &decoded, AVPixelFor
     int bytesConsumed = 0;
 
     decodeFirstStep(encodedPacket, flush);
+    if (flush && m_swsConvertThr)
+        m_swsConvertThr->clear();
 
     if (codec_ctx->codec_type == AVMEDIA_TYPE_VIDEO)
     {
@@ -306,82 +388,81 @@ int FFDecSW::decodeVideo(const Packet &encodedPacket, Frame &decoded, AVPixelFor
             codec_ctx->flags2 &= ~AV_CODEC_FLAG2_FAST;
         }
 
+        const double decodeStartTime = Functions::gettime();
         bytesConsumed = decodeStep(frameFinished);
+        if (frameFinished)
+        {
+            m_decodeTime += Functions::gettime() - decodeStartTime;
+            ++m_decodedFrames;
+        }
 
         if (forceSkipFrames) //Nie możemy pomijać na pierwszej klatce, ponieważ wtedy może nie być odczytany przeplot
             codec_ctx->skip_frame = AVDISCARD_NONREF;
 
+        const bool hasPendingConversion = (m_swsConvertThr && m_swsConvertThr->hasPending());
+
         if (frameFinished && ~hurry_up)
         {
-            bool newFormat = false;
             if (codec_ctx->pix_fmt != lastPixFmt)
             {
                 newPixFmt = codec_ctx->pix_fmt;
                 lastPixFmt = codec_ctx->pix_fmt;
                 setPixelFormat();
-                newFormat = true;
             }
             if (m_desiredPixFmt != AV_PIX_FMT_NONE)
             {
                 if (m_dontConvert && frame->buf[0])
                 {
-                    decoded = Frame(frame);
+                    if (hasPendingConversion)
+                    {
+                        // Return the converted frame first, this one will be returned next time
+                        m_frames.prepend(frame);
+                        frame = av_frame_alloc();
+                        decoded = m_swsConvertThr->take();
+                        frameFinished = !decoded.isEmpty();
+                    }
+                    else
+                    {
+                        decoded = Frame(frame);
 #ifdef USE_VULKAN
-                    if (frame->opaque)
-                        decoded.setVulkanImage(reinterpret_cast<QmVk::Image *>(frame->opaque)->shared_from_this());
+                        if (frame->opaque)
+                            decoded.setVulkanImage(reinterpret_cast<QmVk::Image *>(frame->opaque)->shared_from_this());
 #endif
+                    }
                 }
                 else
                 {
-                    if (frame->width != lastFrameW || frame->height != lastFrameH || newFormat)
-                    {
-                        sws_ctx = sws_getCachedContext(
-                            sws_ctx,
-                            frame->width,
-                            frame->height,
-                            codec_ctx->pix_fmt,
-                            frame->width,
-                            frame->height,
-                            static_cast<AVPixelFormat>(m_desiredPixFmt),
-                            SWS_BILINEAR,
-                            nullptr,
-                            nullptr,
-                            nullptr
-                        );
-                        lastFrameW = frame->width;
-                        lastFrameH = frame->height;
-                    }
+                    // Convert in background while the next frame is being decoded
+                    if (!m_swsConvertThr)
+                        m_swsConvertThr = make_unique<SwsConvertThr>();
+
+                    if (frame->best_effort_timestamp == AV_NOPTS_VALUE && encodedPacket.isTsValid())
+                        frame->best_effort_timestamp = llround(encodedPacket.ts() / av_q2d(m_timeBase));
 
+                    Frame dst;
 #ifdef USE_VULKAN
                     if (m_vkImagePool)
                     {
-                        decoded = m_vkImagePool->takeToFrame(
+                        dst = m_vkImagePool->takeToFrame(
                             vk::Extent2D(frame->width, frame->height),
                             frame,
                             m_desiredPixFmt
                         );
                     }
 #endif
-                    if (decoded.isEmpty())
-                        decoded = Frame::createEmpty(frame, true, m_desiredPixFmt);
-
-                    quint8 *decodedData[] = {
-                        decoded.data(0),
-                        decoded.data(1),
-                        decoded.data(2),
-                    };
-                    sws_scale(
-                        sws_ctx,
-                        frame->data,
-                        frame->linesize,
-                        0,
-                        frame->height,
-                        decodedData,
-                        decoded.linesize()
-                    );
+
+                    decoded = m_swsConvertThr->take();
+                    m_swsConvertThr->convert(frame, m_desiredPixFmt, std::move(dst));
+                    frameFinished = !decoded.isEmpty();
                 }
             }
         }
+        else if (!frameFinished && hasPendingConversion)
+        {
+            // No more frames from the decoder, return the last converted frame
+            decoded = m_swsConvertThr->take();
+            frameFinished = !decoded.isEmpty();
+        }
     }
 
     decodeLastStep(encodedPacket, decoded, frameFinished);
@@ -454,13 +535,42 @@ bool FFDecSW::open(StreamInfo &streamInfo)
         return false;
     if (codec_ctx->codec_type == AVMEDIA_TYPE_VIDEO)
     {
-        if ((codec_ctx->thread_count = threads) != 1)
+        int threadCount = threads;
+        int otherDecoders = g_openVideoDecoders;
+        bool sliceThreads = thread_type_slice;
+        if (m_auxiliary)
+        {
+            // Don't compete with the playback decoders and don't reduce their share
+            threadCount = 1;
+        }
+        else
+        {
+            otherDecoders = g_openVideoDecoders++;
+            m_countedAsVideoDecoder = true;
+
+            if (threadCount == 0)
+            {
+                threadCount = getAutoThreadCount(codec_ctx, otherDecoders);
+                // Use slice threading for codecs which can't decode frames in parallel
+                if (!(codec->capabilities & AV_CODEC_CAP_FRAME_THREADS) && (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS))
+                    sliceThreads = true;
+            }
+        }
+
+        if ((codec_ctx->thread_count = threadCount) != 1)
         {
-            if (!thread_type_slice)
+            if (!sliceThreads)
                 codec_ctx->thread_type = FF_THREAD_FRAME;
             else
                 codec_ctx->thread_type = FF_THREAD_SLICE;
         }
+        qDebug().nospace()
+            << "FFDecSW: " << codec->name << ", "
+            << threadCount << (threadCount == 1 ? " thread" : (sliceThreads ? " slice threads" : " frame threads"))
+            << (threads == 0 && !m_auxiliary ? " (auto)" : "") << ", "
+            << otherDecoders << " other decoder(s)"
+            << (m_auxiliary ? ", auxiliary" : "")
+        ;
         codec_ctx->lowres = qMin<int>(codec->max_lowres, lowres);
         lastPixFmt = codec_ctx->pix_fmt;
 #ifdef USE_VULKAN
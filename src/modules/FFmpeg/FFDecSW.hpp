@@ -20,6 +20,7 @@
 
 #include <FFDec.hpp>
 
+#include <memory>
 #include <deque>
 
 #ifdef USE_VULKAN
@@ -47,7 +48,7 @@ public:
 
 /**/
 
-struct SwsContext;
+class SwsConvertThr;
 
 class FFMPEG_EXPORT FFDecSW final : public FFDec
 {
@@ -65,6 +66,8 @@ private:
 
     void setSupportedPixelFormats(const AVPixelFormats &pixelFormats) override;
 
+    int pendingFrames() const override;
+
     int  decodeAudio(const Packet &encodedPacket, QByteArray &decoded, double &ts, quint8 &channels, quint32 &sampleRate, bool flush) override;
     int  decodeVideo(const Packet &encodedPacket, Frame &decoded, AVPixelFormat &newPixFmt, bool flush, unsigned hurry_up) override;
     bool decodeSubtitle(const QVector<Packet> &encodedPackets, double pos, std::shared_ptr<QMPlay2OSD> &osd, const QSize &size, bool flush) override;
@@ -87,14 +90,17 @@ private:
 private:
     int threads, lowres;
     bool respectHurryUP, skipFrames, forceSkipFrames, thread_type_slice;
-    int lastFrameW, lastFrameH, lastPixFmt;
+    int lastPixFmt;
     int m_teletextPage = 0;
     bool m_teletextTransparent = false;
-    SwsContext *sws_ctx;
+    std::unique_ptr<SwsConvertThr> m_swsConvertThr;
+    double m_decodeTime = 0.0;
+    int m_decodedFrames = 0;
 
     const AVPixFmtDescriptor *m_origPixDesc = nullptr;
     AVPixelFormat m_desiredPixFmt = AV_PIX_FMT_NONE;
     bool m_dontConvert = false;
+    bool m_countedAsVideoDecoder = false;
 
     std::deque<Subtitle> m_subtitles;
 
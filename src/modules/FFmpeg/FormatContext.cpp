@@ -19,6 +19,8 @@
 #include <FFCommon.hpp>
 #include <FormatContext.hpp>
 
+#include <KeyframeIndexer.hpp>
+
 #include <QMPlay2Core.hpp>
 #include <Functions.hpp>
 #include <OggHelper.hpp>
@@ -29,6 +31,7 @@
 #   include <QFile>
 #endif
 
+#include <algorithm>
 #include <limits>
 
 extern "C"
@@ -256,6 +259,7 @@ FormatContext::FormatContext(bool reconnectNetwork, bool allowExperimental) :
 {}
 FormatContext::~FormatContext()
 {
+    m_keyframeIndexer.reset();
     if (formatCtx)
     {
         avformat_close_input(&formatCtx);
@@ -523,7 +527,9 @@ bool FormatContext::seek(double pos, bool backward)
         const double posToSeek = pos + startTime;
         const qint64 timestamp = ((streamsInfo.count() == 1) ? posToSeek : (backward ? floor(posToSeek) : ceil(posToSeek))) * AV_TIME_BASE;
 
-        isOk = av_seek_frame(formatCtx, -1, timestamp, backward ? AVSEEK_FLAG_BACKWARD : 0) >= 0;
+        isOk = seekUsingKeyframeIndex(posToSeek, backward);
+        if (!isOk)
+            isOk = av_seek_frame(formatCtx, -1, timestamp, backward ? AVSEEK_FLAG_BACKWARD : 0) >= 0;
         if (!isOk)
         {
             const int ret = av_read_frame(formatCtx, packet);
@@ -766,6 +772,8 @@ bool FormatContext::open(const QString &_url, const QString &param)
     if (!inputFmt)
     {
         url = Functions::prepareFFmpegUrl(_url, options, false);
+        if (scheme == "file" && oggOffset < 0)
+            m_localFilePath = url;
         if (!isLocal && m_reconnectNetwork)
         {
             av_dict_set(&options, "reconnect", "1", 0);
@@ -1049,12 +1057,80 @@ void FormatContext::selectStreams(const QSet<int> &selectedStreams)
             : AVDISCARD_ALL
         ;
         if (stream->discard == AVDISCARD_DEFAULT)
+        {
             m_allDiscarded = false;
+            if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && !(stream->disposition & AV_DISPOSITION_ATTACHED_PIC))
+                maybeStartKeyframeIndexer(stream);
+        }
     }
 }
 
 /**/
 
+void FormatContext::maybeStartKeyframeIndexer(AVStream *stream)
+{
+    if (m_keyframeIndexer || m_keyframeIndexApplied || m_localFilePath.isEmpty() || stillImage || isStreamed)
+        return;
+
+    const double len = length();
+    if (len <= 0.0)
+        return;
+
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+    const int nIndexEntries = avformat_index_get_entries_count(stream);
+#else
+    const int nIndexEntries = stream->nb_index_entries;
+#endif
+    if (nIndexEntries >= len / 10.0)
+        return; // Demuxer already has a usable index
+
+    m_keyframeIndexer = std::make_unique<KeyframeIndexer>(m_localFilePath, stream->index);
+    m_keyframeIndexerStream = stream;
+    m_keyframeIndexer->start(QThread::LowestPriority);
+}
+bool FormatContext::seekUsingKeyframeIndex(double posToSeek, bool backward)
+{
+    if (!m_keyframeIndexer || !m_keyframeIndexer->isReady())
+        return false;
+
+    const auto &entries = m_keyframeIndexer->entries();
+    if (entries.isEmpty() || m_keyframeIndexerStream->discard == AVDISCARD_ALL)
+        return false;
+
+    const AVRational timeBase {m_keyframeIndexer->timeBaseNum(), m_keyframeIndexer->timeBaseDen()};
+    const qint64 ts = av_rescale_q(posToSeek * AV_TIME_BASE, AV_TIME_BASE_Q, timeBase);
+
+    auto it = std::upper_bound(entries.cbegin(), entries.cend(), ts, [](qint64 ts, const KeyframeIndexer::Entry &entry) {
+        return ts < entry.ts;
+    });
+    if (backward)
+    {
+        if (it == entries.cbegin())
+            return false;
+        --it;
+    }
+    else
+    {
+        if (it != entries.cbegin() && (it - 1)->ts == ts)
+            --it;
+        else if (it == entries.cend())
+            return false;
+    }
+
+    if (!(formatCtx->iformat->flags & AVFMT_NO_BYTE_SEEK))
+    {
+        // Jump directly to the keyframe instead of letting the demuxer guess the position
+        return av_seek_frame(formatCtx, -1, it->pos, AVSEEK_FLAG_BYTE) >= 0;
+    }
+
+    // Feed the demuxer index once, it will use it for all following seeks
+    for (const auto &entry : entries)
+        av_add_index_entry(m_keyframeIndexerStream, entry.pos, entry.ts, entry.size, 0, AVINDEX_KEYFRAME);
+    m_keyframeIndexer.reset();
+    m_keyframeIndexApplied = true;
+    return false;
+}
+
 AVDictionary *FormatContext::getMetadata() const
 {
     return (isStreamed || (!formatCtx->metadata && streamsInfo.count() == 1)) ? streams[0]->metadata : formatCtx->metadata;
@@ -34,6 +34,7 @@ struct AVFormatContext;
 struct AVDictionary;
 struct AVStream;
 struct AVPacket;
+class KeyframeIndexer;
 class OggHelper;
 class Packet;
 #ifdef Q_OS_ANDROID
@@ -81,6 +82,9 @@ private:
     StreamInfo *getStreamInfo(AVStream *stream) const;
     AVDictionary *getMetadata() const;
 
+    void maybeStartKeyframeIndexer(AVStream *stream);
+    bool seekUsingKeyframeIndex(double posToSeek, bool backward);
+
     std::shared_ptr<AbortContext> abortCtx;
 
     QVector<int> index_map;
@@ -111,6 +115,11 @@ private:
 
     double lengthToPlay;
 
+    QString m_localFilePath;
+    std::unique_ptr<KeyframeIndexer> m_keyframeIndexer;
+    AVStream *m_keyframeIndexerStream = nullptr;
+    bool m_keyframeIndexApplied = false;
+
 #ifdef Q_OS_ANDROID
     std::unique_ptr<QFile> m_file;
 #endif
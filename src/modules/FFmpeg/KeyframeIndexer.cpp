@@ -0,0 +1,213 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <KeyframeIndexer.hpp>
+
+#include <QMPlay2Core.hpp>
+#include <Functions.hpp>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QMutex>
+#include <QFile>
+#include <QDir>
+#include <QSet>
+
+extern "C"
+{
+    #include <libavformat/avformat.h>
+}
+
+constexpr quint32 g_cacheVersion = 1;
+constexpr qint64 g_maxCacheSize = 16 * 1024 * 1024;
+
+static QMutex g_indexingMutex;
+static QSet<QString> g_indexing; // Cache files which are being created right now
+
+static int interruptCB(std::atomic_bool *aborted)
+{
+    return *aborted;
+}
+
+KeyframeIndexer::KeyframeIndexer(const QString &filePath, int streamIdx)
+    : m_filePath(filePath)
+    , m_streamIdx(streamIdx)
+{}
+KeyframeIndexer::~KeyframeIndexer()
+{
+    abort();
+    wait();
+}
+
+void KeyframeIndexer::abort()
+{
+    m_aborted = true;
+}
+
+void KeyframeIndexer::run()
+{
+    const QString cacheFile = cacheFilePath();
+    if (cacheFile.isEmpty())
+        return;
+
+    if (loadCache(cacheFile))
+    {
+        m_ready = true;
+        return;
+    }
+
+    {
+        QMutexLocker locker(&g_indexingMutex);
+        if (g_indexing.contains(cacheFile))
+            return; // Other instance is indexing the same file
+        g_indexing.insert(cacheFile);
+    }
+
+    if (scan())
+    {
+        saveCache(cacheFile);
+        m_ready = true;
+    }
+
+    QMutexLocker locker(&g_indexingMutex);
+    g_indexing.remove(cacheFile);
+}
+
+QString KeyframeIndexer::cacheFilePath() const
+{
+    const QFileInfo fileInfo(m_filePath);
+    if (!fileInfo.isFile())
+        return QString();
+
+    const QByteArray key = fileInfo.absoluteFilePath().toUtf8()
+        + ':' + QByteArray::number(fileInfo.size())
+        + ':' + QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch())
+        + ':' + QByteArray::number(m_streamIdx)
+    ;
+
+    return QMPlay2Core.getCacheDir() + "KeyframeIndex/" + QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+}
+bool KeyframeIndexer::loadCache(const QString &cacheFile)
+{
+    QFile f(cacheFile);
+    if (!f.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&f);
+
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> version >> m_timeBaseNum >> m_timeBaseDen >> count;
+    if (stream.status() != QDataStream::Ok || version != g_cacheVersion || m_timeBaseNum <= 0 || m_timeBaseDen <= 0 || count < 0)
+        return false;
+
+    m_entries.resize(count);
+    for (Entry &entry : m_entries)
+        stream >> entry.pos >> entry.ts >> entry.size;
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        m_entries.clear();
+        return false;
+    }
+
+    // The modification time is the last access time for the eviction
+    f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+void KeyframeIndexer::saveCache(const QString &cacheFile) const
+{
+    const QString dir = QFileInfo(cacheFile).path();
+    QDir().mkpath(dir);
+
+    QSaveFile f(cacheFile);
+    if (!f.open(QFile::WriteOnly))
+        return;
+
+    QDataStream stream(&f);
+    stream << g_cacheVersion << m_timeBaseNum << m_timeBaseDen << (qint32)m_entries.count();
+    for (const Entry &entry : m_entries)
+        stream << entry.pos << entry.ts << entry.size;
+
+    if (stream.status() != QDataStream::Ok || !f.commit())
+        return;
+
+    Functions::evictOldFiles(dir, g_maxCacheSize);
+}
+
+bool KeyframeIndexer::scan()
+{
+    AVFormatContext *formatCtx = avformat_alloc_context();
+    formatCtx->interrupt_callback.callback = (int(*)(void *))interruptCB;
+    formatCtx->interrupt_callback.opaque = &m_aborted;
+
+    if (avformat_open_input(&formatCtx, m_filePath.toUtf8(), nullptr, nullptr) != 0)
+        return false; // "formatCtx" is freed on failure
+
+    bool ok = false;
+
+    if (m_streamIdx >= 0 && m_streamIdx < (int)formatCtx->nb_streams)
+    {
+        for (unsigned i = 0; i < formatCtx->nb_streams; ++i)
+        {
+            if ((int)i != m_streamIdx)
+                formatCtx->streams[i]->discard = AVDISCARD_ALL;
+        }
+
+        const AVStream *stream = formatCtx->streams[m_streamIdx];
+        m_timeBaseNum = stream->time_base.num;
+        m_timeBaseDen = stream->time_base.den;
+
+        AVPacket *packet = av_packet_alloc();
+        qint64 lastTs = AV_NOPTS_VALUE;
+        int ret = 0;
+        while (!m_aborted && (ret = av_read_frame(formatCtx, packet)) != AVERROR_EOF)
+        {
+            if (ret < 0)
+            {
+                if (ret == AVERROR_INVALIDDATA)
+                    continue;
+                break;
+            }
+
+            if (packet->stream_index == m_streamIdx && (packet->flags & AV_PKT_FLAG_KEY) && packet->pos >= 0)
+            {
+                const qint64 ts = (packet->pts != AV_NOPTS_VALUE) ? packet->pts : packet->dts;
+                if (ts != AV_NOPTS_VALUE && (lastTs == AV_NOPTS_VALUE || ts > lastTs))
+                {
+                    m_entries.append({packet->pos, ts, packet->size});
+                    lastTs = ts;
+                }
+            }
+
+            av_packet_unref(packet);
+        }
+        av_packet_free(&packet);
+
+        ok = !m_aborted && ret == AVERROR_EOF && m_timeBaseNum > 0 && m_timeBaseDen > 0;
+    }
+
+    avformat_close_input(&formatCtx);
+
+    if (!ok)
+        m_entries.clear();
+    return ok;
+}
@@ -0,0 +1,80 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QVector>
+#include <QThread>
+#include <QString>
+
+#include <atomic>
+
+/* Scans a local file in background and collects the keyframe positions of one stream */
+class KeyframeIndexer final : public QThread
+{
+public:
+    struct Entry
+    {
+        qint64 pos;
+        qint64 ts; // In "timeBase" units
+        qint32 size;
+    };
+
+    KeyframeIndexer(const QString &filePath, int streamIdx);
+    ~KeyframeIndexer();
+
+    inline bool isReady() const
+    {
+        return m_ready;
+    }
+
+    // Valid only when "isReady()" returns true
+    inline const QVector<Entry> &entries() const
+    {
+        return m_entries;
+    }
+    inline int timeBaseNum() const
+    {
+        return m_timeBaseNum;
+    }
+    inline int timeBaseDen() const
+    {
+        return m_timeBaseDen;
+    }
+
+    void abort();
+
+private:
+    void run() override;
+
+    QString cacheFilePath() const;
+    bool loadCache(const QString &cacheFile);
+    void saveCache(const QString &cacheFile) const;
+
+    bool scan();
+
+private:
+    const QString m_filePath;
+    const int m_streamIdx;
+
+    QVector<Entry> m_entries;
+    int m_timeBaseNum = 0, m_timeBaseDen = 0;
+
+    std::atomic_bool m_aborted {false};
+    std::atomic_bool m_ready {false};
+};
@@ -0,0 +1,274 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <SwsConvertThr.hpp>
+
+#include <Functions.hpp>
+
+extern "C"
+{
+    #include <libswscale/swscale.h>
+    #include <libavutil/imgutils.h>
+    #include <libavutil/pixdesc.h>
+    #include <libavutil/frame.h>
+    #include <libavutil/opt.h>
+}
+
+static int getSwsThreadCount(int w, int h)
+{
+    // Slice threads don't pay off for small frames
+    const qint64 pixels = qint64(w) * h;
+    if (pixels <= 1280 * 720)
+        return 1;
+    const int maxThreads = qBound(1, QThread::idealThreadCount() / 2, 8);
+    if (pixels <= 1920 * 1080)
+        return qMin(maxThreads, 2);
+    return maxThreads;
+}
+
+SwsConvertThr::SwsConvertThr()
+{
+    setObjectName("SwsConvertThr");
+    start();
+}
+SwsConvertThr::~SwsConvertThr()
+{
+    m_mutex.lock();
+    m_br = true;
+    m_cond.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+
+    av_frame_free(&m_src);
+    sws_freeContext(m_swsCtx);
+    for (auto &&pool : m_pools)
+        av_buffer_pool_uninit(&pool);
+}
+
+void SwsConvertThr::convert(const AVFrame *src, AVPixelFormat dstPixFmt, Frame &&dst)
+{
+    QMutexLocker locker(&m_mutex);
+    Q_ASSERT(!m_pending);
+
+    if (!m_src)
+        m_src = av_frame_alloc();
+    av_frame_ref(m_src, src);
+
+    m_dstPixFmt = dstPixFmt;
+    m_dst = std::move(dst);
+
+    m_pending = true;
+    m_converted = false;
+    m_cond.wakeAll();
+}
+
+bool SwsConvertThr::hasPending() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending;
+}
+Frame SwsConvertThr::take()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending)
+        return Frame();
+
+    waitForConverted();
+
+    Frame frame = std::move(m_dst);
+    m_dst.clear();
+    m_pending = false;
+    return frame;
+}
+
+void SwsConvertThr::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending)
+        return;
+
+    waitForConverted();
+
+    m_dst.clear();
+    m_pending = false;
+}
+
+void SwsConvertThr::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_br)
+    {
+        if (!m_pending || m_converted)
+        {
+            m_cond.wait(&m_mutex);
+            continue;
+        }
+
+        // The frames belong to this thread until the conversion is finished
+        locker.unlock();
+        convertFrame();
+        locker.relock();
+
+        m_converted = true;
+        m_cond.wakeAll();
+    }
+}
+
+void SwsConvertThr::waitForConverted()
+{
+    if (m_converted)
+        return;
+
+    const double t = Functions::gettime();
+    while (!m_converted)
+        m_cond.wait(&m_mutex);
+    m_waitTime += Functions::gettime() - t;
+}
+
+bool SwsConvertThr::prepareContext(const AVFrame *src)
+{
+    if (m_swsCtx && src->width == m_srcW && src->height == m_srcH && src->format == m_srcPixFmt && m_dstPixFmt == m_ctxDstPixFmt)
+        return true;
+
+    sws_freeContext(m_swsCtx);
+
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(6, 1, 100)
+    m_swsCtx = sws_alloc_context();
+    if (m_swsCtx)
+    {
+        av_opt_set_int(m_swsCtx, "srcw", src->width, 0);
+        av_opt_set_int(m_swsCtx, "srch", src->height, 0);
+        av_opt_set_int(m_swsCtx, "src_format", src->format, 0);
+        av_opt_set_int(m_swsCtx, "dstw", src->width, 0);
+        av_opt_set_int(m_swsCtx, "dsth", src->height, 0);
+        av_opt_set_int(m_swsCtx, "dst_format", m_dstPixFmt, 0);
+        av_opt_set_int(m_swsCtx, "sws_flags", SWS_BILINEAR, 0);
+        av_opt_set_int(m_swsCtx, "threads", getSwsThreadCount(src->width, src->height), 0);
+        if (sws_init_context(m_swsCtx, nullptr, nullptr) < 0)
+        {
+            sws_freeContext(m_swsCtx);
+            m_swsCtx = nullptr;
+        }
+    }
+#else
+    m_swsCtx = sws_getContext(
+        src->width,
+        src->height,
+        static_cast<AVPixelFormat>(src->format),
+        src->width,
+        src->height,
+        m_dstPixFmt,
+        SWS_BILINEAR,
+        nullptr,
+        nullptr,
+        nullptr
+    );
+#endif
+
+    m_srcW = src->width;
+    m_srcH = src->height;
+    m_srcPixFmt = src->format;
+    m_ctxDstPixFmt = m_dstPixFmt;
+
+    return (m_swsCtx != nullptr);
+}
+bool SwsConvertThr::getPooledFrame(AVFrame *dst)
+{
+    const AVPixFmtDescriptor *pixDesc = av_pix_fmt_desc_get(m_dstPixFmt);
+    const int numPlanes = av_pix_fmt_count_planes(m_dstPixFmt);
+    if (!pixDesc || numPlanes <= 0 || numPlanes > 4)
+        return false;
+
+    int linesize[4] = {};
+    if (av_image_fill_linesizes(linesize, m_dstPixFmt, m_srcW) < 0)
+        return false;
+
+    dst->format = m_dstPixFmt;
+    dst->width = m_srcW;
+    dst->height = m_srcH;
+
+    for (int p = 0; p < numPlanes; ++p)
+    {
+        const bool isChroma = (p == 1 || p == 2);
+        const int h = isChroma ? AV_CEIL_RSHIFT(m_srcH, pixDesc->log2_chroma_h) : m_srcH;
+        const int alignedLinesize = FFALIGN(linesize[p], 64);
+        const int size = alignedLinesize * h + 64;
+
+        if (m_poolSizes[p] != size)
+        {
+            // Buffers still in use are freed when they are released
+            av_buffer_pool_uninit(&m_pools[p]);
+            m_pools[p] = av_buffer_pool_init(size, nullptr);
+            m_poolSizes[p] = size;
+        }
+
+        dst->buf[p] = m_pools[p] ? av_buffer_pool_get(m_pools[p]) : nullptr;
+        if (!dst->buf[p])
+            return false;
+
+        dst->data[p] = dst->buf[p]->data;
+        dst->linesize[p] = alignedLinesize;
+    }
+    dst->extended_data = dst->data;
+
+    return true;
+}
+void SwsConvertThr::convertFrame()
+{
+    const double t = Functions::gettime();
+
+    if (!prepareContext(m_src))
+    {
+        m_dst.clear();
+    }
+    else if (m_dst.isEmpty())
+    {
+        AVFrame *dst = av_frame_alloc();
+        if (getPooledFrame(dst))
+        {
+            av_frame_copy_props(dst, m_src);
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(6, 1, 100)
+            const bool ok = (sws_scale_frame(m_swsCtx, dst, m_src) >= 0);
+#else
+            const bool ok = (sws_scale(m_swsCtx, m_src->data, m_src->linesize, 0, m_src->height, dst->data, dst->linesize) > 0);
+#endif
+            if (ok)
+                m_dst = Frame(dst, m_dstPixFmt);
+        }
+        av_frame_free(&dst);
+    }
+    else
+    {
+        // Preallocated frame, e.g. Vulkan image
+        sws_scale(
+            m_swsCtx,
+            m_src->data,
+            m_src->linesize,
+            0,
+            m_src->height,
+            m_dst.dataArr(),
+            m_dst.linesize()
+        );
+    }
+
+    av_frame_unref(m_src);
+
+    ++m_convertedFrames;
+    m_convertTime += Functions::gettime() - t;
+}
@@ -0,0 +1,95 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Frame.hpp>
+
+#include <QWaitCondition>
+#include <QThread>
+#include <QMutex>
+
+struct AVBufferPool;
+struct SwsContext;
+struct AVFrame;
+
+/*
+ * Pixel format conversion stage of the software video decoder. It converts
+ * one frame in background while the decoder works on the next one, using
+ * slice-threaded swscale and pooled destination buffers.
+ */
+class SwsConvertThr final : public QThread
+{
+public:
+    SwsConvertThr();
+    ~SwsConvertThr();
+
+    // Takes a reference of "src", "dst" can be a preallocated frame (e.g. Vulkan image)
+    void convert(const AVFrame *src, AVPixelFormat dstPixFmt, Frame &&dst);
+
+    bool hasPending() const;
+    Frame take();
+
+    void clear();
+
+    inline int convertedFrames() const
+    {
+        return m_convertedFrames;
+    }
+    inline double convertTime() const
+    {
+        return m_convertTime;
+    }
+    inline double waitTime() const
+    {
+        return m_waitTime;
+    }
+
+private:
+    void run() override;
+
+    void waitForConverted();
+
+    bool prepareContext(const AVFrame *src);
+    bool getPooledFrame(AVFrame *dst);
+    void convertFrame();
+
+private:
+    bool m_br = false;
+    bool m_pending = false;
+    bool m_converted = false;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_cond;
+
+    AVFrame *m_src = nullptr;
+    AVPixelFormat m_dstPixFmt = AV_PIX_FMT_NONE;
+    Frame m_dst;
+
+    // Used by the conversion thread only
+    SwsContext *m_swsCtx = nullptr;
+    int m_srcW = 0, m_srcH = 0;
+    int m_srcPixFmt = AV_PIX_FMT_NONE;
+    int m_ctxDstPixFmt = AV_PIX_FMT_NONE;
+    AVBufferPool *m_pools[4] = {};
+    int m_poolSizes[4] = {};
+
+    int m_convertedFrames = 0;
+    double m_convertTime = 0.0;
+    double m_waitTime = 0.0;
+};
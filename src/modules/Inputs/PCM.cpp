@@ -18,10 +18,13 @@
 
 #include <PCM.hpp>
 
-#include <ByteArray.hpp>
 #include <Packet.hpp>
 #include <Reader.hpp>
 
+#include <QtEndian>
+
+#include <cstring>
+
 /**/
 
 constexpr quint8 bytes[PCM::FORMAT_COUNT] =
@@ -29,6 +32,16 @@ constexpr quint8 bytes[PCM::FORMAT_COUNT] =
     1, 1, 2, 3, 4, 4
 };
 
+// Duration of audio read at once, large packets keep the packet buffer small for high sample rates
+constexpr double g_blockDuration = 0.05;
+constexpr int g_minBlockFrames = 256;
+
+template<typename T, bool bigEndian>
+static inline T load(const quint8 *src)
+{
+    return bigEndian ? qFromBigEndian<T>(src) : qFromLittleEndian<T>(src);
+}
+
 /**/
 
 PCM::PCM(Module &module)
@@ -87,46 +100,64 @@ bool PCM::read(Packet &decoded, int &idx)
 
     decoded.setTS((reader->pos() - offset) / (double)bytes[fmt] / chn / srate);
 
-    const QByteArray dataBA = reader->read(chn * bytes[fmt] * 256);
+    const QByteArray dataBA = reader->read(blockBytes);
     const int samples_with_channels = dataBA.size() / bytes[fmt];
     decoded.resize(samples_with_channels * sizeof(float));
-    float *decoded_data = (float *)decoded.data();
-    ByteArray data(dataBA.constData(), dataBA.size(), bigEndian);
+    if (bigEndian)
+        convert<true>((const quint8 *)dataBA.constData(), (float *)decoded.data(), samples_with_channels);
+    else
+        convert<false>((const quint8 *)dataBA.constData(), (float *)decoded.data(), samples_with_channels);
+
+    idx = 0;
+    decoded.setDuration(decoded.size() / chn / sizeof(float) / (double)srate);
+
+    return decoded.size();
+}
+template<bool bigEndian>
+void PCM::convert(const quint8 *__restrict__ src, float *__restrict__ dst, int samples) const
+{
+    // One loop per format without per-sample branches, so the compiler can vectorize it
     switch (fmt)
     {
         case PCM_U8:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = (data.getBYTE() - 0x7F) / 128.0f;
+            for (int i = 0; i < samples; i++)
+                dst[i] = (src[i] - 0x7F) / 128.0f;
             break;
         case PCM_S8:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = (qint8)data.getBYTE() / 128.0f;
+            for (int i = 0; i < samples; i++)
+                dst[i] = (qint8)src[i] / 128.0f;
             break;
         case PCM_S16:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = (qint16)data.getWORD() / 32768.0f;
+            for (int i = 0; i < samples; i++)
+                dst[i] = load<qint16, bigEndian>(src + i * 2) / 32768.0f;
             break;
         case PCM_S24:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = (qint32)data.get24bAs32b() / 2147483648.0f;
+            for (int i = 0; i < samples; i++)
+            {
+                const quint8 *s = src + i * 3;
+                const quint32 v = bigEndian
+                    ? ((quint32)s[0] << 24) | (s[1] << 16) | (s[2] << 8)
+                    : ((quint32)s[2] << 24) | (s[1] << 16) | (s[0] << 8)
+                ;
+                dst[i] = (qint32)v / 2147483648.0f;
+            }
             break;
         case PCM_S32:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = (qint32)data.getDWORD() / 2147483648.0f;
+            for (int i = 0; i < samples; i++)
+                dst[i] = load<qint32, bigEndian>(src + i * 4) / 2147483648.0f;
             break;
         case PCM_FLT:
-            for (int i = 0; i < samples_with_channels; i++)
-                decoded_data[i] = data.getFloat();
+            for (int i = 0; i < samples; i++)
+            {
+                const quint32 v = load<quint32, bigEndian>(src + i * 4);
+                memcpy(dst + i, &v, sizeof(float));
+            }
             break;
         default:
             break;
     }
-
-    idx = 0;
-    decoded.setDuration(decoded.size() / chn / sizeof(float) / (double)srate);
-
-    return decoded.size();
 }
+
 void PCM::abort()
 {
     reader.abort();
@@ -141,6 +172,8 @@ bool PCM::open(const QString &url)
         else
             len = -1.0;
 
+        blockBytes = qMax<int>(g_minBlockFrames, srate * g_blockDuration) * chn * bytes[fmt];
+
         streams_info += new StreamInfo(srate, chn);
         return true;
     }
@@ -44,6 +44,9 @@ private:
 
     bool open(const QString &) override;
 
+    template<bool bigEndian>
+    void convert(const quint8 *__restrict__ src, float *__restrict__ dst, int samples) const;
+
     /**/
 
     IOController<Reader> reader;
@@ -52,6 +55,7 @@ private:
     FORMAT fmt;
     unsigned char chn;
     int srate, offset;
+    int blockBytes;
     bool bigEndian;
 };
 
@@ -22,6 +22,9 @@
 #include <Packet.hpp>
 #include <Reader.hpp>
 
+constexpr double g_blockDuration = 0.05;
+constexpr int g_minBlockCodes = 256;
+
 /**/
 
 static float decode(unsigned char nibble, short &stepIndex, int &predictor)
@@ -125,7 +128,8 @@ bool Rayman2::read(Packet &decoded, int &idx)
 
     decoded.setTS((reader->pos() - 0x64) * 2.0 / chn / srate);
 
-    const QByteArray sampleCodes = reader->read(chn * 256);
+    // Each byte holds two samples, read about "g_blockDuration" of audio at once
+    const QByteArray sampleCodes = reader->read(chn * qMax<int>(g_minBlockCodes, srate * g_blockDuration / 2.0));
 
     decoded.resize(sampleCodes.size() * sizeof(float) * 2);
     float *decodedData = (float *)decoded.data();
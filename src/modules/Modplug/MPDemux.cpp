@@ -41,21 +41,9 @@ MPDemux::~MPDemux()
 
 bool MPDemux::set()
 {
-    bool restartPlaying = false;
-
-    QMPlay2ModPlug::Settings settings;
-    QMPlay2ModPlug::GetSettings(&settings);
-    if (settings.mResamplingMode != sets().getInt("ModplugResamplingMethod"))
-    {
-        settings.mResamplingMode = sets().getInt("ModplugResamplingMethod");
-        restartPlaying = true;
-    }
-    settings.mFlags = QMPlay2ModPlug::ENABLE_OVERSAMPLING;
-    settings.mChannels = 2;
-    settings.mBits = 32;
-    settings.mFrequency = srate;
-    QMPlay2ModPlug::SetSettings(&settings);
-
+    const int resamplingMode = sets().getInt("ModplugResamplingMethod");
+    const bool restartPlaying = (mpfile && resamplingMode != m_resamplingMode);
+    m_resamplingMode = resamplingMode;
     return !restartPlaying && sets().getBool("ModplugEnabled");
 }
 
@@ -149,16 +137,10 @@ bool MPDemux::read(Packet &decoded, int &idx)
         return false;
 
     decoded.resize(1024 * 2 * 4); //BASE_SIZE * CHN * BITS/8
-    decoded.resize(QMPlay2ModPlug::Read(mpfile, decoded.data(), decoded.size()));
+    decoded.resize(QMPlay2ModPlug::Read(mpfile, decoded.data(), decoded.size())); // Mixer outputs float directly
     if (!decoded.size())
         return false;
 
-    //Konwersja 32bit-int na 32bit-float
-    float *decodedFloat = (float *)decoded.data();
-    const int *decodedInt = (const int *)decodedFloat;
-    for (unsigned i = 0; i < decoded.size() / sizeof(float); ++i)
-        decodedFloat[i] = decodedInt[i] / 2147483648.0;
-
     idx = 0;
     decoded.setTS(pos);
     decoded.setDuration((double)decoded.size() / (srate * 2 * 4)); //SRATE * CHN * BITS/8
@@ -177,7 +159,16 @@ bool MPDemux::open(const QString &url)
     if (Reader::create(url, reader))
     {
         if (reader->size() > 0)
-            mpfile = QMPlay2ModPlug::Load(reader->read(reader->size()), reader->size());
+        {
+            QMPlay2ModPlug::Settings settings;
+            QMPlay2ModPlug::GetDefaultSettings(&settings);
+            settings.mFlags = QMPlay2ModPlug::ENABLE_OVERSAMPLING | QMPlay2ModPlug::ENABLE_FLOAT_OUTPUT;
+            settings.mResamplingMode = m_resamplingMode;
+            settings.mChannels = 2;
+            settings.mBits = 32;
+            settings.mFrequency = srate;
+            mpfile = QMPlay2ModPlug::Load(reader->read(reader->size()), reader->size(), &settings);
+        }
         reader.reset();
         if (mpfile && QMPlay2ModPlug::GetModuleType(mpfile))
         {
@@ -54,6 +54,7 @@ private:
     bool aborted;
     double pos;
     quint32 srate;
+    int m_resamplingMode = -1;
     QMPlay2ModPlug::File *mpfile;
     IOController<Reader> reader;
 };
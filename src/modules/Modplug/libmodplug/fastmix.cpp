@@ -11,30 +11,6 @@
 
 namespace QMPlay2ModPlug {
 
-// Front Mix Buffer (Also room for interleaved rear mix)
-int MixSoundBuffer[MIXBUFFERSIZE*4];
-
-// Reverb Mix Buffer
-#ifndef MODPLUG_NO_REVERB
-int MixReverbBuffer[MIXBUFFERSIZE*2];
-extern UINT gnReverbSend;
-#endif
-
-#ifndef MODPLUG_FASTSOUNDLIB
-int MixRearBuffer[MIXBUFFERSIZE*2];
-float MixFloatBuffer[MIXBUFFERSIZE*2];
-#endif
-
-#ifdef MSC_VER
-#pragma bss_seg()
-#endif
-
-
-extern LONG gnDryROfsVol;
-extern LONG gnDryLOfsVol;
-extern LONG gnRvbROfsVol;
-extern LONG gnRvbLOfsVol;
-
 // 4x256 taps polyphase FIR resampling filter
 extern short int gFastSinc[];
 extern short int gKaiserSinc[]; // 8-taps polyphase
@@ -1996,6 +1972,31 @@ DWORD MPPASMCALL X86_Convert32To32(LPVOID lp16, int *pBuffer, DWORD lSampleCount
 #endif
 
 
+// Clip and convert directly to normalized float samples (no intermediate 32-bit integer pass),
+// the loop has no branches, so the compiler can vectorize it.
+DWORD MPPASMCALL X86_Convert32ToFloat(LPVOID lpFloat, int *pBuffer, DWORD lSampleCount, LPLONG lpMin, LPLONG lpMax)
+//--------------------------------------------------------------------------------------------------------------
+{
+	const float scale = 1.0f / (float)(1u << (31 - MIXING_ATTENUATION));
+	const int *__restrict in = pBuffer;
+	float *__restrict out = (float *)lpFloat;
+	int vumin = *lpMin, vumax = *lpMax;
+
+	for (DWORD i = 0; i < lSampleCount; i++)
+	{
+		int n = in[i];
+		n = (n < MIXING_CLIPMIN) ? MIXING_CLIPMIN : n;
+		n = (n > MIXING_CLIPMAX) ? MIXING_CLIPMAX : n;
+		vumin = (n < vumin) ? n : vumin;
+		vumax = (n > vumax) ? n : vumax;
+		out[i] = (float)n * scale;
+	}
+	*lpMin = vumin;
+	*lpMax = vumax;
+	return lSampleCount * 4;
+}
+
+
 #ifdef MSC_VER
 void MPPASMCALL X86_InitMixBuffer(int *pBuffer, UINT nSamples)
 //------------------------------------------------------------
@@ -2362,7 +2363,6 @@ UINT MPPASMCALL X86_AGC(int *pBuffer, UINT nSamples, UINT nAGC)
 void CSoundFile::ProcessAGC(int count)
 //------------------------------------
 {
-	static DWORD gAGCRecoverCount = 0;
 	UINT agc = X86_AGC(MixSoundBuffer, count, gnAGC);
 	// Some kind custom law, so that the AGC stays quite stable, but slowly
 	// goes back up if the sound level stays below a level inversely
@@ -13,9 +13,11 @@ namespace QMPlay2ModPlug {
 	struct File
 	{
 		CSoundFile mSoundFile;
+		int mSampleSize;
+		int mLength; // Cached, "GetSongTime()" simulates the whole song
 	};
 
-	Settings gSettings =
+	static const Settings gDefaultSettings =
 	{
 		ENABLE_OVERSAMPLING | ENABLE_NOISE_REDUCTION,
 
@@ -35,59 +37,66 @@ namespace QMPlay2ModPlug {
 		0
 	};
 
-	int gSampleSize;
-
-	static void UpdateSettings(bool updateBasicConfig)
+	static void UpdateSettings(File* file, const Settings* settings, bool updateBasicConfig)
 	{
-		if(gSettings.mFlags & ENABLE_REVERB)
+		CSoundFile &soundFile = file->mSoundFile;
+
+		if(settings->mFlags & ENABLE_REVERB)
 		{
-			CSoundFile::SetReverbParameters(gSettings.mReverbDepth,
-			                                gSettings.mReverbDelay);
+			soundFile.SetReverbParameters(settings->mReverbDepth,
+			                              settings->mReverbDelay);
 		}
 
-		if(gSettings.mFlags & ENABLE_MEGABASS)
+		if(settings->mFlags & ENABLE_MEGABASS)
 		{
-			CSoundFile::SetXBassParameters(gSettings.mBassAmount,
-			                               gSettings.mBassRange);
+			soundFile.SetXBassParameters(settings->mBassAmount,
+			                             settings->mBassRange);
 		}
 		else // modplug seems to ignore the SetWaveConfigEx() setting for bass boost
-			CSoundFile::SetXBassParameters(0, 0);
+			soundFile.SetXBassParameters(0, 0);
 
-		if(gSettings.mFlags & ENABLE_SURROUND)
+		if(settings->mFlags & ENABLE_SURROUND)
 		{
-			CSoundFile::SetSurroundParameters(gSettings.mSurroundDepth,
-			                                  gSettings.mSurroundDelay);
+			soundFile.SetSurroundParameters(settings->mSurroundDepth,
+			                                settings->mSurroundDelay);
 		}
 
 		if(updateBasicConfig)
 		{
-			CSoundFile::SetWaveConfig(gSettings.mFrequency,
-                                      gSettings.mBits,
-                                      gSettings.mChannels);
-			CSoundFile::SetMixConfig(gSettings.mStereoSeparation,
-                                     gSettings.mMaxMixChannels);
-
-			gSampleSize = gSettings.mBits / 8 * gSettings.mChannels;
+			const bool floatOutput = (settings->mFlags & ENABLE_FLOAT_OUTPUT) && settings->mBits == 32;
+			if(floatOutput)
+				soundFile.gdwSoundSetup |= SNDMIX_FLOATOUTPUT;
+			else
+				soundFile.gdwSoundSetup &= ~SNDMIX_FLOATOUTPUT;
+
+			soundFile.SetWaveConfig(settings->mFrequency,
+			                        settings->mBits,
+			                        settings->mChannels);
+			soundFile.SetMixConfig(settings->mStereoSeparation,
+			                       settings->mMaxMixChannels);
+
+			file->mSampleSize = settings->mBits / 8 * settings->mChannels;
 		}
 
-		CSoundFile::SetWaveConfigEx(gSettings.mFlags & ENABLE_SURROUND,
-                                    !(gSettings.mFlags & ENABLE_OVERSAMPLING),
-                                    gSettings.mFlags & ENABLE_REVERB,
-                                    true,
-                                    gSettings.mFlags & ENABLE_MEGABASS,
-                                    gSettings.mFlags & ENABLE_NOISE_REDUCTION,
-                                    false);
-		CSoundFile::SetResamplingMode(gSettings.mResamplingMode);
+		soundFile.SetWaveConfigEx(settings->mFlags & ENABLE_SURROUND,
+		                          !(settings->mFlags & ENABLE_OVERSAMPLING),
+		                          settings->mFlags & ENABLE_REVERB,
+		                          true,
+		                          settings->mFlags & ENABLE_MEGABASS,
+		                          settings->mFlags & ENABLE_NOISE_REDUCTION,
+		                          false);
+		soundFile.SetResamplingMode(settings->mResamplingMode);
 	}
 
 
-File* Load(const void* data, int size)
+File* Load(const void* data, int size, const Settings* settings)
 {
 	File* result = new File;
-	UpdateSettings(true);
+	UpdateSettings(result, settings, true);
 	if(result->mSoundFile.Create((const BYTE*)data, size))
 	{
-		result->mSoundFile.SetRepeatCount(gSettings.mLoopCount);
+		result->mSoundFile.SetRepeatCount(settings->mLoopCount);
+		result->mLength = result->mSoundFile.GetSongTime() * 1000;
 		return result;
 	}
 	else
@@ -105,7 +114,7 @@ void Unload(File* file)
 
 int Read(File* file, void* buffer, int size)
 {
-	return file->mSoundFile.Read(buffer, size) * gSampleSize;
+	return file->mSoundFile.Read(buffer, size) * file->mSampleSize;
 }
 
 const char* GetName(File* file)
@@ -115,7 +124,7 @@ const char* GetName(File* file)
 
 int GetLength(File* file)
 {
-	return file->mSoundFile.GetSongTime() * 1000;
+	return file->mLength;
 }
 
 void InitMixerCallback(File* file,ModPlugMixerProc proc)
@@ -252,7 +261,7 @@ ModPlugNote* GetPattern(File* file,int pattern,unsigned int* numrows) {
 void Seek(File* file, int millisecond)
 {
 	int maxpos;
-	int maxtime = file->mSoundFile.GetSongTime() * 1000;
+	int maxtime = file->mLength;
 	float postime;
 
 	if(millisecond > maxtime)
@@ -265,15 +274,14 @@ void Seek(File* file, int millisecond)
 	file->mSoundFile.SetCurrentPos((int)(millisecond * postime));
 }
 
-void GetSettings(Settings* settings)
+void GetDefaultSettings(Settings* settings)
 {
-	memcpy(settings, &gSettings, sizeof(Settings));
+	memcpy(settings, &gDefaultSettings, sizeof(Settings));
 }
 
-void SetSettings(const Settings* settings)
+void SetSettings(File* file, const Settings* settings)
 {
-	memcpy(&gSettings, settings, sizeof(Settings));
-	UpdateSettings(false); // do not update basic config.
+	UpdateSettings(file, settings, false); // do not update basic config.
 }
 
 } //namespace ModPlug
@@ -10,6 +10,7 @@
 namespace QMPlay2ModPlug {
 
 struct File;
+struct Settings;
 
 struct ModPlugNote {
 	unsigned char Note;
@@ -25,7 +26,7 @@ typedef void (*ModPlugMixerProc)(int*, unsigned long, unsigned long);
 /* Load a mod file.  [data] should point to a block of memory containing the complete
  * file, and [size] should be the size of that block.
  * Return the loaded mod file on success, or NULL on failure. */
-File* Load(const void* data, int size);
+File* Load(const void* data, int size, const Settings* settings);
 /* Unload a mod file. */
 void Unload(File* file);
 
@@ -38,7 +39,7 @@ int  Read(File* file, void* buffer, int size);
 const char* GetName(File* file);
 
 /* Get the length of the mod, in milliseconds.  Note that this result is not always
- * accurate, especially in the case of mods with loops. */
+ * accurate, especially in the case of mods with loops.  It is computed once on load. */
 int GetLength(File* file);
 
 /* Seek to a particular position in the song.  Note that seeking and MODs don't mix very
@@ -55,7 +56,8 @@ enum Flags
     ENABLE_NOISE_REDUCTION  = 1 << 1,  /* Enable noise reduction */
     ENABLE_REVERB           = 1 << 2,  /* Enable reverb */
     ENABLE_MEGABASS         = 1 << 3,  /* Enable megabass */
-    ENABLE_SURROUND         = 1 << 4   /* Enable surround sound. */
+    ENABLE_SURROUND         = 1 << 4,  /* Enable surround sound. */
+    ENABLE_FLOAT_OUTPUT     = 1 << 5   /* Output normalized float samples, requires 32 bits per sample */
 };
 
 enum ResamplingMode
@@ -90,11 +92,12 @@ struct Settings
 	                        -1 loops forever. */
 };
 
-/* Get and set the mod decoder settings.  All options, except for channels, bits-per-sample,
- * sampling rate, and loop count, will take effect immediately.  Those options which don't
- * take effect immediately will take effect the next time you load a mod. */
-void GetSettings(Settings* settings);
-void SetSettings(const Settings* settings);
+/* Get the default settings and change the settings of a loaded mod.  Each mod has its own
+ * mixer, so several mods can be decoded from different threads at the same time.  All options,
+ * except for channels, bits-per-sample, sampling rate, float output, and loop count, will take
+ * effect immediately.  Those are only used by Load(). */
+void GetDefaultSettings(Settings* settings);
+void SetSettings(File* file, const Settings* settings);
 
 /* New ModPlug API Functions */
 /* NOTE: Master Volume (1-512) */
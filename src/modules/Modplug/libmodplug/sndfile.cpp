@@ -74,6 +74,47 @@ CSoundFile::CSoundFile()
 	memset(Patterns, 0, sizeof(Patterns));
 	memset(m_szNames, 0, sizeof(m_szNames));
 	memset(m_MixPlugins, 0, sizeof(m_MixPlugins));
+	// Mixer Configuration
+	m_nXBassDepth = 6;
+	m_nXBassRange = XBASS_DELAY;
+	m_nReverbDepth = 1;
+	m_nReverbDelay = 100;
+	gnReverbType = 0;
+	m_nProLogicDepth = 12;
+	m_nProLogicDelay = 20;
+	m_nStereoSeparation = 128;
+	m_nMaxMixChannels = 32;
+	m_nStreamVolume = 0x8000;
+	gdwSysInfo = 0;
+	gnChannels = 1;
+	gdwSoundSetup = 0;
+	gdwMixingFreq = 44100;
+	gnBitsPerSample = 16;
+	gnAGC = AGC_UNITY;
+	gnVolumeRampSamples = 64;
+	gnVUMeter = 0;
+	gnCPUUsage = 0;
+	gpSndMixHook = NULL;
+	gpMixPluginCreateProc = NULL;
+	// Mixer State
+	memset(MixSoundBuffer, 0, sizeof(MixSoundBuffer));
+	memset(MixRearBuffer, 0, sizeof(MixRearBuffer));
+	memset(MixFloatBuffer, 0, sizeof(MixFloatBuffer));
+	gnDryROfsVol = gnDryLOfsVol = 0;
+	gnRvbROfsVol = gnRvbLOfsVol = 0;
+	gbInitPlugins = 0;
+#ifndef NO_AGC
+	gAGCRecoverCount = 0;
+#endif
+#ifndef MODPLUG_NO_REVERB
+	memset(MixReverbBuffer, 0, sizeof(MixReverbBuffer));
+	gnReverbSend = 0;
+	nReverbSize = 0;
+	nFilterAttn = 0;
+#endif
+	nXBassMask = 0;
+	nLeftNR = nRightNR = 0;
+	InitializeDSP(TRUE);
 }
 
 
@@ -271,6 +271,7 @@ typedef const BYTE * LPCBYTE;
 #define SNDMIX_ENABLEMMX		0x20000
 #define SNDMIX_NOBACKWARDJUMPS	0x40000
 #define SNDMIX_MAXDEFAULTPAN	0x80000	// Used by the MOD loader
+#define SNDMIX_FLOATOUTPUT		0x100000	// 32-bit float output instead of 32-bit integer
 
 
 // Reverb Types (GM2 Presets)
@@ -526,23 +527,89 @@ typedef struct MODMIDICFG
 
 typedef VOID (* LPSNDMIXHOOKPROC)(int *, unsigned long, unsigned long); // buffer, samples, channels
 
+#define MIXBUFFERSIZE		512
+#define MIXING_ATTENUATION	4
+#define MIXING_CLIPMIN		(-0x08000000)
+#define MIXING_CLIPMAX		(0x07FFFFFF)
+#define VOLUMERAMPPRECISION	12
+#define FADESONGDELAY		100
+#define EQ_BUFFERSIZE		(MIXBUFFERSIZE)
+#define AGC_PRECISION		9
+#define AGC_UNITY			(1 << AGC_PRECISION)
+
+// DSP Effects
+#define XBASS_DELAY			14	// 2.5 ms
+
+// DSP Buffer Sizes
+#define XBASSBUFFERSIZE		64		// 2 ms at 50KHz
+#define FILTERBUFFERSIZE	64		// 1.25 ms
+#define SURROUNDBUFFERSIZE	((MAX_SAMPLE_RATE * 50) / 1000)
+#define REVERBBUFFERSIZE	((MAX_SAMPLE_RATE * 200) / 1000)
+#define REVERBBUFFERSIZE2	((REVERBBUFFERSIZE*13) / 17)
+#define REVERBBUFFERSIZE3	((REVERBBUFFERSIZE*7) / 13)
+#define REVERBBUFFERSIZE4	((REVERBBUFFERSIZE*7) / 19)
+
 
 
 //==============
 class CSoundFile
 //==============
 {
-public:	// Static Members
-	static UINT m_nXBassDepth, m_nXBassRange;
-	static UINT m_nReverbDepth, m_nReverbDelay, gnReverbType;
-	static UINT m_nProLogicDepth, m_nProLogicDelay;
-	static UINT m_nStereoSeparation;
-	static UINT m_nMaxMixChannels;
-	static LONG m_nStreamVolume;
-	static DWORD gdwSysInfo, gdwSoundSetup, gdwMixingFreq, gnBitsPerSample, gnChannels;
-	static UINT gnAGC, gnVolumeRampSamples, gnVUMeter, gnCPUUsage;
-	static LPSNDMIXHOOKPROC gpSndMixHook;
-	static PMIXPLUGINCREATEPROC gpMixPluginCreateProc;
+public:	// Mixer Configuration (per instance, so several files can be mixed at the same time)
+	UINT m_nXBassDepth, m_nXBassRange;
+	UINT m_nReverbDepth, m_nReverbDelay, gnReverbType;
+	UINT m_nProLogicDepth, m_nProLogicDelay;
+	UINT m_nStereoSeparation;
+	UINT m_nMaxMixChannels;
+	LONG m_nStreamVolume;
+	DWORD gdwSysInfo, gdwSoundSetup, gdwMixingFreq, gnBitsPerSample, gnChannels;
+	UINT gnAGC, gnVolumeRampSamples, gnVUMeter, gnCPUUsage;
+	LPSNDMIXHOOKPROC gpSndMixHook;
+	PMIXPLUGINCREATEPROC gpMixPluginCreateProc;
+
+public:	// Mixer State
+	int MixSoundBuffer[MIXBUFFERSIZE*4];
+	int MixRearBuffer[MIXBUFFERSIZE*2];
+	float MixFloatBuffer[MIXBUFFERSIZE*2];
+	LONG gnDryROfsVol, gnDryLOfsVol;
+	LONG gnRvbROfsVol, gnRvbLOfsVol;
+	int gbInitPlugins;
+#ifndef NO_AGC
+	DWORD gAGCRecoverCount;
+#endif
+#ifndef MODPLUG_NO_REVERB
+	int MixReverbBuffer[MIXBUFFERSIZE*2];
+	UINT gnReverbSend;
+#endif
+
+	// DSP Effects: Bass Expansion (low-pass filter)
+	LONG nXBassSum, nXBassBufferPos, nXBassDlyPos, nXBassMask;
+	LONG XBassBuffer[XBASSBUFFERSIZE];
+	LONG XBassDelay[XBASSBUFFERSIZE];
+	// DSP Effects: Noise Reduction (simple low-pass filter)
+	LONG nLeftNR, nRightNR;
+	// DSP Effects: Surround Encoding (1 delay line + low-pass filter + high-pass filter)
+	LONG nSurroundSize, nSurroundPos, nDolbyDepth;
+	LONG nDolbyLoDlyPos, nDolbyLoFltPos, nDolbyLoFltSum;
+	LONG nDolbyHiFltPos, nDolbyHiFltSum;
+	LONG DolbyLoFilterBuffer[XBASSBUFFERSIZE];
+	LONG DolbyLoFilterDelay[XBASSBUFFERSIZE];
+	LONG DolbyHiFilterBuffer[FILTERBUFFERSIZE];
+	LONG SurroundBuffer[SURROUNDBUFFERSIZE];
+#ifndef MODPLUG_NO_REVERB
+	// DSP Effects: Reverb (4 delay lines + high-pass filter + low-pass filter)
+	LONG nReverbSize, nReverbBufferPos, nReverbSize2, nReverbBufferPos2;
+	LONG nReverbSize3, nReverbBufferPos3, nReverbSize4, nReverbBufferPos4;
+	LONG nReverbLoFltSum, nReverbLoFltPos, nReverbLoDlyPos, nFilterAttn;
+	LONG gRvbLowPass[8];
+	LONG gRvbLPPos, gRvbLPSum;
+	LONG ReverbLoFilterBuffer[XBASSBUFFERSIZE];
+	LONG ReverbLoFilterDelay[XBASSBUFFERSIZE];
+	LONG ReverbBuffer[REVERBBUFFERSIZE];
+	LONG ReverbBuffer2[REVERBBUFFERSIZE2];
+	LONG ReverbBuffer3[REVERBBUFFERSIZE3];
+	LONG ReverbBuffer4[REVERBBUFFERSIZE4];
+#endif
 
 public:	// for Editing
 	MODCHANNEL Chn[MAX_CHANNELS];					// Channels
@@ -666,33 +733,33 @@ public:
 
 public:
 	// Mixer Config
-	static BOOL InitPlayer(BOOL bReset=FALSE);
-	static BOOL SetMixConfig(UINT nStereoSeparation, UINT nMaxMixChannels);
-	static BOOL SetWaveConfig(UINT nRate,UINT nBits,UINT nChannels,BOOL bMMX=FALSE);
-	static BOOL SetResamplingMode(UINT nMode); // SRCMODE_XXXX
-	static BOOL IsStereo() { return (gnChannels > 1) ? TRUE : FALSE; }
-	static DWORD GetSampleRate() { return gdwMixingFreq; }
-	static DWORD GetBitsPerSample() { return gnBitsPerSample; }
-	static DWORD InitSysInfo();
-	static DWORD GetSysInfo() { return gdwSysInfo; }
+	BOOL InitPlayer(BOOL bReset=FALSE);
+	BOOL SetMixConfig(UINT nStereoSeparation, UINT nMaxMixChannels);
+	BOOL SetWaveConfig(UINT nRate,UINT nBits,UINT nChannels,BOOL bMMX=FALSE);
+	BOOL SetResamplingMode(UINT nMode); // SRCMODE_XXXX
+	BOOL IsStereo() { return (gnChannels > 1) ? TRUE : FALSE; }
+	DWORD GetSampleRate() { return gdwMixingFreq; }
+	DWORD GetBitsPerSample() { return gnBitsPerSample; }
+	DWORD InitSysInfo();
+	DWORD GetSysInfo() { return gdwSysInfo; }
 	// AGC
-	static BOOL GetAGC() { return (gdwSoundSetup & SNDMIX_AGC) ? TRUE : FALSE; }
-	static void SetAGC(BOOL b);
-	static void ResetAGC();
-	static void ProcessAGC(int count);
+	BOOL GetAGC() { return (gdwSoundSetup & SNDMIX_AGC) ? TRUE : FALSE; }
+	void SetAGC(BOOL b);
+	void ResetAGC();
+	void ProcessAGC(int count);
 
 	//GCCFIX -- added these functions back in!
-	static BOOL SetWaveConfigEx(BOOL bSurround,BOOL bNoOverSampling,BOOL bReverb,BOOL hqido,BOOL bMegaBass,BOOL bNR,BOOL bEQ);
+	BOOL SetWaveConfigEx(BOOL bSurround,BOOL bNoOverSampling,BOOL bReverb,BOOL hqido,BOOL bMegaBass,BOOL bNR,BOOL bEQ);
 	// DSP Effects
-	static void InitializeDSP(BOOL bReset);
-	static void ProcessStereoDSP(int count);
-	static void ProcessMonoDSP(int count);
+	void InitializeDSP(BOOL bReset);
+	void ProcessStereoDSP(int count);
+	void ProcessMonoDSP(int count);
 	// [Reverb level 0(quiet)-100(loud)], [delay in ms, usually 40-200ms]
-	static BOOL SetReverbParameters(UINT nDepth, UINT nDelay);
+	BOOL SetReverbParameters(UINT nDepth, UINT nDelay);
 	// [XBass level 0(quiet)-100(loud)], [cutoff in Hz 10-100]
-	static BOOL SetXBassParameters(UINT nDepth, UINT nRange);
+	BOOL SetXBassParameters(UINT nDepth, UINT nRange);
 	// [Surround level 0(quiet)-100(heavy)] [delay in ms, usually 5-40ms]
-	static BOOL SetSurroundParameters(UINT nDepth, UINT nDelay);
+	BOOL SetSurroundParameters(UINT nDepth, UINT nDelay);
 public:
 	BOOL ReadNote();
 	BOOL ProcessRow();
@@ -910,15 +977,6 @@ typedef struct WAVEEXTRAHEADER
 ///////////////////////////////////////////////////////////
 // Low-level Mixing functions
 
-#define MIXBUFFERSIZE		512
-#define MIXING_ATTENUATION	4
-#define MIXING_CLIPMIN		(-0x08000000)
-#define MIXING_CLIPMAX		(0x07FFFFFF)
-#define VOLUMERAMPPRECISION	12
-#define FADESONGDELAY		100
-#define EQ_BUFFERSIZE		(MIXBUFFERSIZE)
-#define AGC_PRECISION		9
-#define AGC_UNITY			(1 << AGC_PRECISION)
 
 // Calling conventions
 #ifdef MSC_VER
@@ -23,16 +23,25 @@
 #include <Functions.hpp>
 
 #include <QCoreApplication>
+#include <QtMath>
 #include <QPainter>
 
+#include <cmath>
+
 extern "C" {
     #include <libavutil/cpu.h>
     #include <libavutil/mem.h>
 }
 
 Drawable::Drawable(QPainterWriter &writer) :
+    VideoOutputCommon(false),
     writer(writer)
 {
+    m_widget = this;
+    m_matrixChangeFn = [this] {
+        draw(Frame(), true, true);
+    };
+
     grabGesture(Qt::PinchGesture);
     setAutoFillBackground(true);
     setMouseTracking(true);
@@ -41,6 +50,15 @@ Drawable::Drawable(QPainterWriter &writer) :
 Drawable::~Drawable()
 {}
 
+bool Drawable::setSphericalView(bool sphericalView)
+{
+    if (!VideoOutputCommon::setSphericalView(sphericalView))
+        return false;
+    if (!sphericalView)
+        m_sphericalRemap.clear();
+    return true;
+}
+
 void Drawable::draw(const Frame &newVideoFrame, bool canRepaint, bool entireScreen)
 {
     if (!newVideoFrame.isEmpty())
@@ -50,24 +68,48 @@ void Drawable::draw(const Frame &newVideoFrame, bool canRepaint, bool entireScre
         update();
         return;
     }
-    m_scaleByQt = (imgW > videoFrame.width()) || (imgH > videoFrame.height());
-    if (imgScaler.create(videoFrame, m_scaleByQt ? -1 : imgW, m_scaleByQt ? -1 : imgH))
+    auto createImg = [this](int w, int h) {
+        auto imgData = reinterpret_cast<uint8_t *>(av_malloc(w * h * 4 + av_cpu_max_align()));
+        img = QImage(imgData, w, h, QImage::Format_RGB32, [](void *ptr) {
+            av_free(ptr);
+        }, imgData);
+    };
+    bool hasNewImg = false;
+    if (m_sphericalView)
     {
-        auto createImg = [this](int w, int h) {
-            auto imgData = reinterpret_cast<uint8_t *>(av_malloc(w * h * 4 + av_cpu_max_align()));
-            img = QImage(imgData, w, h, QImage::Format_RGB32, [](void *ptr) {
-                av_free(ptr);
-            }, imgData);
-        };
-        if (m_scaleByQt && (img.width() != videoFrame.width() || img.height() != videoFrame.height()))
+        // The remap table is rebuilt only when the view changes
+        m_scaleByQt = false;
+        m_sphericalRemap.setView(
+            qDegreesToRadians(90.0 - m_rot.y()),
+            qDegreesToRadians(90.0 - m_rot.x()),
+            tan(qDegreesToRadians(34.0)) / qMax(writer.zoom, 0.5)
+        );
+        if (m_sphericalRemap.remap(videoFrame, imgW, imgH) && imgScaler.create(m_sphericalRemap.outFrame()))
         {
-            createImg(videoFrame.width(), videoFrame.height());
+            if (img.width() != imgW || img.height() != imgH)
+                createImg(imgW, imgH);
+            imgScaler.scale(m_sphericalRemap.outData(), m_sphericalRemap.outLinesize(), img.bits());
+            hasNewImg = true;
         }
-        else if (!m_scaleByQt && (img.width() != imgW || img.height() != imgH))
+    }
+    else
+    {
+        m_scaleByQt = (imgW > videoFrame.width()) || (imgH > videoFrame.height());
+        if (imgScaler.create(videoFrame, m_scaleByQt ? -1 : imgW, m_scaleByQt ? -1 : imgH))
         {
-            createImg(imgW, imgH);
+            if (m_scaleByQt && (img.width() != videoFrame.width() || img.height() != videoFrame.height()))
+            {
+                createImg(videoFrame.width(), videoFrame.height());
+            }
+            else if (!m_scaleByQt && (img.width() != imgW || img.height() != imgH))
+            {
+                createImg(imgW, imgH);
+            }
+            hasNewImg = imgScaler.scale(videoFrame, img.bits());
         }
-        imgScaler.scale(videoFrame, img.bits());
+    }
+    if (hasNewImg)
+    {
         if (writer.flip)
             img = img.mirrored(writer.flip & Qt::Horizontal, writer.flip & Qt::Vertical);
         if (Brightness != 0 || Contrast != 100)
@@ -82,8 +124,20 @@ void Drawable::draw(const Frame &newVideoFrame, bool canRepaint, bool entireScre
 void Drawable::resizeEvent(QResizeEvent *e)
 {
     const qreal dpr = devicePixelRatioF();
-    Functions::getImageSize(writer.aspect_ratio, writer.zoom, width(), height(), W, H, &X, &Y);
-    Functions::getImageSize(writer.aspect_ratio, writer.zoom, width() * dpr, height() * dpr, imgW, imgH);
+    if (m_sphericalView)
+    {
+        // Spherical view always fills the whole widget
+        X = Y = 0;
+        W = width();
+        H = height();
+        imgW = W * dpr;
+        imgH = H * dpr;
+    }
+    else
+    {
+        Functions::getImageSize(writer.aspect_ratio, writer.zoom, width(), height(), W, H, &X, &Y);
+        Functions::getImageSize(writer.aspect_ratio, writer.zoom, width() * dpr, height() * dpr, imgW, imgH);
+    }
 
     imgScaler.destroy();
     img = QImage();
@@ -113,6 +167,12 @@ bool Drawable::event(QEvent *e)
     /* Pass gesture and touch event to the parent */
     switch (e->type())
     {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseMove:
+            if (m_sphericalView)
+                dispatchEvent(e, parent());
+            return QWidget::event(e);
         case QEvent::TouchBegin:
         case QEvent::TouchUpdate:
         case QEvent::TouchEnd:
@@ -137,6 +197,7 @@ QPainterWriter::QPainterWriter(Module &module) :
     addParam("Flip");
     addParam("Brightness");
     addParam("Contrast");
+    addParam("Spherical");
 
     SetModule(module);
 }
@@ -167,6 +228,9 @@ bool QPainterWriter::processParams(bool *)
     const int _flip = getParam("Flip").toInt();
     const int Contrast = getParam("Contrast").toInt() + 100;
     const int Brightness = getParam("Brightness").toInt() * 256 / 100;
+    const bool spherical = getParam("Spherical").toBool();
+    if (drawable->setSphericalView(spherical))
+        doResizeEvent = drawable->isVisible();
     if (_aspect_ratio != aspect_ratio || _zoom != zoom || _flip != flip || Contrast != drawable->Contrast || Brightness != drawable->Brightness)
     {
         zoom = _zoom;
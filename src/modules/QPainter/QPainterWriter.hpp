@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <VideoOutputCommon.hpp>
+#include <SphericalRemap.hpp>
 #include <VideoWriter.hpp>
 #include <Frame.hpp>
 #include <ImgScaler.hpp>
@@ -27,12 +29,14 @@
 class QPainterWriter;
 class QMPlay2OSD;
 
-class Drawable final : public QWidget
+class Drawable final : public QWidget, public VideoOutputCommon
 {
 public:
     Drawable(class QPainterWriter &);
     ~Drawable();
 
+    bool setSphericalView(bool sphericalView) override;
+
     void draw(const Frame &newVideoFrame, bool, bool);
 
     void resizeEvent(QResizeEvent *) override;
@@ -48,6 +52,7 @@ private:
     QPainterWriter &writer;
     QImage img;
     ImgScaler imgScaler;
+    SphericalRemap m_sphericalRemap;
     bool m_scaleByQt = false;
 };
 
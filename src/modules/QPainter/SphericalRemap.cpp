@@ -0,0 +1,201 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <SphericalRemap.hpp>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+extern "C" {
+    #include <libavutil/common.h>
+}
+
+using namespace std;
+
+SphericalRemap::SphericalRemap()
+{
+    m_threadsPool.setMaxThreadCount(min(QThread::idealThreadCount(), 16));
+}
+SphericalRemap::~SphericalRemap()
+{
+}
+
+void SphericalRemap::setView(double yaw, double pitch, double tanHalfFov)
+{
+    if (qFuzzyCompare(m_yaw, yaw) && qFuzzyCompare(m_pitch, pitch) && qFuzzyCompare(m_tanHalfFov, tanHalfFov))
+        return;
+
+    m_yaw = yaw;
+    m_pitch = pitch;
+    m_tanHalfFov = tanHalfFov;
+    m_viewChanged = true;
+}
+
+bool SphericalRemap::remap(const Frame &src, int dstW, int dstH)
+{
+    if (src.isEmpty() || !src.hasCPUAccess() || dstW < 1 || dstH < 1 || src.width() > 0xFFFF || src.height() > 0xFFFF)
+        return false;
+
+    if (m_outFrame.isEmpty()
+            || m_outFrame.width() != dstW
+            || m_outFrame.height() != dstH
+            || m_outFrame.pixelFormat() != src.pixelFormat()
+            || m_outFrame.colorSpace() != src.colorSpace()
+            || m_outFrame.isLimited() != src.isLimited())
+    {
+        m_outFrame = Frame::createEmpty(
+            dstW,
+            dstH,
+            src.pixelFormat(),
+            false,
+            false,
+            src.colorSpace(),
+            src.isLimited(),
+            src.colorPrimaries(),
+            src.colorTrc()
+        );
+        for (int p = 0; p < 3; ++p)
+        {
+            m_outLinesize[p] = FFALIGN(m_outFrame.width(p), 32);
+            m_outPlanes[p].resize(m_outLinesize[p] * m_outFrame.height(p));
+            m_outData[p] = m_outPlanes[p].data();
+        }
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Lut &lut = m_luts[i];
+        const int srcW = src.width(i), srcH = src.height(i);
+        const int outW = m_outFrame.width(i), outH = m_outFrame.height(i);
+        if (m_viewChanged || lut.srcW != srcW || lut.srcH != srcH || lut.dstW != outW || lut.dstH != outH)
+            buildLut(lut, srcW, srcH, outW, outH);
+    }
+    m_viewChanged = false;
+
+    runJobs(m_outFrame.height(1), [&](const int jobId, const int jobsCount) {
+        for (int p = 0; p < 3; ++p)
+        {
+            const Lut &lut = m_luts[p == 0 ? 0 : 1];
+
+            const int srcLinesize = src.linesize(p);
+            const quint8 *srcData = src.constData(p);
+
+            const int dstLinesize = m_outLinesize[p];
+            quint8 *dstData = m_outPlanes[p].data();
+
+            const int yBegin = lut.dstH * jobId / jobsCount;
+            const int yEnd = lut.dstH * (jobId + 1) / jobsCount;
+            for (int y = yBegin; y < yEnd; ++y)
+            {
+                const LutEntry *entry = lut.entries.data() + y * lut.dstW;
+                quint8 *dst = dstData + y * dstLinesize;
+                for (int x = 0; x < lut.dstW; ++x, ++entry)
+                {
+                    const quint8 *row0 = srcData + entry->y0 * srcLinesize;
+                    const quint8 *row1 = srcData + entry->y1 * srcLinesize;
+                    const int fx = entry->fx, fy = entry->fy;
+                    const int top    = row0[entry->x0] * (256 - fx) + row0[entry->x1] * fx;
+                    const int bottom = row1[entry->x0] * (256 - fx) + row1[entry->x1] * fx;
+                    dst[x] = (top * (256 - fy) + bottom * fy + 32768) >> 16;
+                }
+            }
+        }
+    });
+
+    return true;
+}
+void SphericalRemap::clear()
+{
+    m_outFrame.clear();
+    for (auto &&plane : m_outPlanes)
+        vector<quint8>().swap(plane);
+    for (auto &&lut : m_luts)
+        lut = Lut();
+    m_viewChanged = true;
+}
+
+void SphericalRemap::buildLut(Lut &lut, int srcW, int srcH, int dstW, int dstH)
+{
+    lut.srcW = srcW;
+    lut.srcH = srcH;
+    lut.dstW = dstW;
+    lut.dstH = dstH;
+    lut.entries.resize(dstW * dstH);
+
+    const double sinYaw = sin(m_yaw), cosYaw = cos(m_yaw);
+    const double sinPitch = sin(m_pitch), cosPitch = cos(m_pitch);
+    const double tanHalfFovX = m_tanHalfFov * dstW / dstH;
+
+    runJobs(dstH, [&](const int jobId, const int jobsCount) {
+        const int yBegin = dstH * jobId / jobsCount;
+        const int yEnd = dstH * (jobId + 1) / jobsCount;
+        for (int y = yBegin; y < yEnd; ++y)
+        {
+            LutEntry *entry = lut.entries.data() + y * dstW;
+            const double camY = (1.0 - 2.0 * (y + 0.5) / dstH) * m_tanHalfFov;
+            for (int x = 0; x < dstW; ++x, ++entry)
+            {
+                const double camX = (2.0 * (x + 0.5) / dstW - 1.0) * tanHalfFovX;
+
+                // Pitch around X axis, then yaw around Y axis
+                const double dirY = camY * cosPitch + sinPitch;
+                const double dirZ0 = cosPitch - camY * sinPitch;
+                const double dirX = camX * cosYaw + dirZ0 * sinYaw;
+                const double dirZ = dirZ0 * cosYaw - camX * sinYaw;
+
+                const double lon = atan2(dirX, dirZ);
+                const double lat = atan2(dirY, hypot(dirX, dirZ));
+
+                const double u = (lon / (2.0 * M_PI) + 0.5) * srcW - 0.5;
+                const double v = (0.5 - lat / M_PI) * srcH - 0.5;
+
+                const double uFloor = floor(u);
+                int x0 = static_cast<int>(uFloor) % srcW;
+                if (x0 < 0)
+                    x0 += srcW;
+                entry->x0 = x0;
+                entry->x1 = (x0 + 1 < srcW) ? x0 + 1 : 0; // Wrap around the seam
+                entry->fx = lround((u - uFloor) * 256.0);
+
+                const double vClamped = qBound(0.0, v, srcH - 1.0);
+                const int y0 = static_cast<int>(vClamped);
+                entry->y0 = y0;
+                entry->y1 = min(y0 + 1, srcH - 1);
+                entry->fy = lround((vClamped - y0) * 256.0);
+            }
+        }
+    });
+}
+
+void SphericalRemap::runJobs(int maxJobs, const function<void(int jobId, int jobsCount)> &fn)
+{
+    const int jobsCount = max(min(m_threadsPool.maxThreadCount(), maxJobs), 1);
+
+    vector<QFuture<void>> threads;
+    threads.reserve(jobsCount - 1);
+
+    for (int i = 1; i < jobsCount; ++i)
+        threads.push_back(QtConcurrent::run(&m_threadsPool, fn, i, jobsCount));
+    fn(0, jobsCount);
+
+    for (auto &&thread : threads)
+        thread.waitForFinished();
+}
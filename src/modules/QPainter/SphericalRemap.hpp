@@ -0,0 +1,83 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Frame.hpp>
+
+#include <QThreadPool>
+
+#include <functional>
+#include <vector>
+
+/* Equirectangular to rectilinear reprojection using a precomputed remap table */
+
+class SphericalRemap
+{
+public:
+    SphericalRemap();
+    ~SphericalRemap();
+
+    void setView(double yaw, double pitch, double tanHalfFov);
+
+    bool remap(const Frame &src, int dstW, int dstH);
+    void clear();
+
+    inline const Frame &outFrame() const
+    {
+        return m_outFrame;
+    }
+    inline const void **outData()
+    {
+        return m_outData;
+    }
+    inline const int *outLinesize() const
+    {
+        return m_outLinesize;
+    }
+
+private:
+    struct LutEntry
+    {
+        quint16 x0, x1;
+        quint16 y0, y1;
+        quint16 fx, fy;
+    };
+    struct Lut
+    {
+        int srcW = 0, srcH = 0;
+        int dstW = 0, dstH = 0;
+        std::vector<LutEntry> entries;
+    };
+
+    void buildLut(Lut &lut, int srcW, int srcH, int dstW, int dstH);
+    void runJobs(int maxJobs, const std::function<void(int jobId, int jobsCount)> &fn);
+
+private:
+    QThreadPool m_threadsPool;
+
+    double m_yaw = 0.0, m_pitch = 0.0, m_tanHalfFov = 0.0;
+    bool m_viewChanged = true;
+
+    Lut m_luts[2]; // luma, chroma
+
+    Frame m_outFrame;
+    std::vector<quint8> m_outPlanes[3];
+    const void *m_outData[3] = {};
+    int m_outLinesize[3] = {};
+};
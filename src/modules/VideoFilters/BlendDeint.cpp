@@ -22,6 +22,7 @@
 BlendDeint::BlendDeint()
     : VideoFilter(true)
 {
+    addGenericCPUPixelFormats();
     addParam("DeinterlaceFlags");
     addParam("W");
     addParam("H");
@@ -42,14 +43,16 @@ bool BlendDeint::filter(QQueue<Frame> &framesQueue)
             videoFrame = std::move(newFrame);
         }
 #endif
-        for (int p = 0; p < 3; ++p)
+        const auto averageTwoLines = VideoFilters::averageTwoLinesFn(videoFrame);
+        const int numPlanes = videoFrame.numPlanes();
+        for (int p = 0; p < numPlanes; ++p)
         {
             const int linesize = videoFrame.linesize(p);
             quint8 *data = videoFrame.data(p) + linesize;
             const int h = videoFrame.height(p) - 2;
             for (int i = 0; i < h; ++i)
             {
-                VideoFilters::averageTwoLines(data, data, data + linesize, linesize);
+                averageTwoLines(data, data, data + linesize, linesize);
                 data += linesize;
             }
         }
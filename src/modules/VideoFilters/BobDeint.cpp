@@ -24,6 +24,7 @@
 BobDeint::BobDeint()
     : VideoFilter(true)
 {
+    addGenericCPUPixelFormats();
     addParam("DeinterlaceFlags");
     addParam("W");
     addParam("H");
@@ -41,7 +42,9 @@ bool BobDeint::filter(QQueue<Frame> &framesQueue)
 
         const bool parity = (isTopFieldFirst(sourceFrame) == m_secondFrame);
 
-        for (int p = 0; p < 3; ++p)
+        const auto averageTwoLines = VideoFilters::averageTwoLinesFn(sourceFrame);
+        const int numPlanes = sourceFrame.numPlanes();
+        for (int p = 0; p < numPlanes; ++p)
         {
             const int linesizeSrc = sourceFrame.linesize(p);
             const int linesizeDst = destFrame.linesize(p);
@@ -63,7 +66,7 @@ bool BobDeint::filter(QQueue<Frame> &framesQueue)
                 memcpy(dst, src, minLinesize);
                 dst += linesizeDst;
 
-                VideoFilters::averageTwoLines(dst, src, src + (linesizeSrc << 1), minLinesize);
+                averageTwoLines(dst, src, src + (linesizeSrc << 1), minLinesize);
                 dst += linesizeDst;
 
                 src += linesizeSrc << 1;
@@ -22,6 +22,7 @@
 DiscardDeint::DiscardDeint()
     : VideoFilter(true)
 {
+    addGenericCPUPixelFormats();
     addParam("DeinterlaceFlags");
     addParam("W");
     addParam("H");
@@ -43,7 +44,9 @@ bool DiscardDeint::filter(QQueue<Frame> &framesQueue)
             videoFrame = std::move(newFrame);
         }
 #endif
-        for (int p = 0; p < 3; ++p)
+        const auto averageTwoLines = VideoFilters::averageTwoLinesFn(videoFrame);
+        const int numPlanes = videoFrame.numPlanes();
+        for (int p = 0; p < numPlanes; ++p)
         {
             const int linesize = videoFrame.linesize(p);
             quint8 *data = videoFrame.data(p);
@@ -56,7 +59,7 @@ bool DiscardDeint::filter(QQueue<Frame> &framesQueue)
             data += linesize;
             for (int i = 0; i < lines; ++i)
             {
-                VideoFilters::averageTwoLines(data, data - linesize, data + linesize, linesize);
+                averageTwoLines(data, data - linesize, data + linesize, linesize);
                 data += linesize << 1;
             }
             if (TFF)
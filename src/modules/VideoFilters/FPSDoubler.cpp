@@ -37,17 +37,29 @@ bool FPSDoubler::set()
 
     m_onlyFullScreen = sets().getBool("FPSDoubler/OnlyFullScreen");
 
+    m_motionInterpolation = sets().getBool("FPSDoubler/MotionInterpolation");
+    if (!m_motionInterpolation)
+        m_motionInterpolator.clear();
+
     return true;
 }
 
+void FPSDoubler::clearBuffer()
+{
+    m_lastFrame.clear();
+    m_motionInterpolator.clear();
+    VideoFilter::clearBuffer();
+}
+
 bool FPSDoubler::filter(QQueue<Frame> &framesQueue)
 {
     addFramesToInternalQueue(framesQueue);
     if (!m_internalQueue.isEmpty())
     {
         auto frame = m_internalQueue.dequeue();
-        framesQueue.enqueue(frame);
         const auto frameTs = frame.ts();
+        bool doubleFrame = false;
+        Frame midFrame;
         if (!qIsNaN(m_lastTS))
         {
             m_frameTimeSum += frameTs - m_lastTS;
@@ -58,7 +70,29 @@ bool FPSDoubler::filter(QQueue<Frame> &framesQueue)
                 m_frameTimeSum = 0.0;
                 m_frames = 0;
             }
-            if (m_fps > m_minFps && m_fps < m_maxFps && (!m_onlyFullScreen || m_fullScreen))
+            doubleFrame = (m_fps > m_minFps && m_fps < m_maxFps && (!m_onlyFullScreen || m_fullScreen));
+            if (doubleFrame && m_motionInterpolation && MotionInterpolator::isSupported(frame) && MotionInterpolator::isSupported(m_lastFrame))
+            {
+                // Spend at most half of the output frame time on interpolation
+                midFrame = m_motionInterpolator.interpolate(m_lastFrame, frame, 0.25 / m_fps);
+            }
+        }
+        // Don't keep a reference to frames which can't be interpolated (e.g. hardware frames)
+        if (m_motionInterpolation && MotionInterpolator::isSupported(frame))
+            m_lastFrame = frame;
+        else
+            m_lastFrame.clear();
+        if (!midFrame.isEmpty())
+        {
+            // Interpolated frame goes between the previous and the current frame
+            midFrame.setTS((m_lastTS + frameTs) / 2.0);
+            framesQueue.enqueue(midFrame);
+            framesQueue.enqueue(frame);
+        }
+        else
+        {
+            framesQueue.enqueue(frame);
+            if (doubleFrame)
             {
                 frame.setTS(getMidFrameTS(frameTs, m_lastTS));
                 framesQueue.enqueue(frame);
@@ -77,6 +111,7 @@ bool FPSDoubler::processParams(bool *)
     m_frames = 0;
 
     m_lastTS = qQNaN();
+    m_lastFrame.clear();
 
     return true;
 }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <MotionInterpolator.hpp>
 #include <VideoFilter.hpp>
 
 class FPSDoubler final : public VideoFilter
@@ -28,6 +29,8 @@ public:
 
     bool set() override;
 
+    void clearBuffer() override;
+
     bool filter(QQueue<Frame> &framesQueue) override;
 
     bool processParams(bool *paramsCorrected) override;
@@ -38,11 +41,15 @@ private:
     double m_minFps = 0.0;
     double m_maxFps = 0.0;
     bool m_onlyFullScreen = false;
+    bool m_motionInterpolation = false;
 
     double m_fps = 0.0;
 
     double m_frameTimeSum = 0.0;
     int m_frames = 0;
+
+    Frame m_lastFrame;
+    MotionInterpolator m_motionInterpolator;
 };
 
 #define FPSDoublerName "FPS Doubler"
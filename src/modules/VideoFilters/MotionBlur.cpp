@@ -25,6 +25,7 @@
 MotionBlur::MotionBlur()
     : VideoFilter(true)
 {
+    addGenericCPUPixelFormats();
     addParam("W");
     addParam("H");
 }
@@ -38,7 +39,9 @@ bool MotionBlur::filter(QQueue<Frame> &framesQueue)
         Frame videoFrame2 = getNewFrame(videoFrame1);
         const Frame &videoFrame3 = m_internalQueue.at(0);
 
-        for (int p = 0; p < 3; ++p)
+        const auto averageTwoLines = VideoFilters::averageTwoLinesFn(videoFrame1);
+        const int numPlanes = videoFrame1.numPlanes();
+        for (int p = 0; p < numPlanes; ++p)
         {
             const quint8 *src1 = videoFrame1.constData(p);
             const quint8 *src2 = videoFrame3.constData(p);
@@ -50,7 +53,7 @@ bool MotionBlur::filter(QQueue<Frame> &framesQueue)
             const int h = videoFrame1.height(p);
             for (int i = 0; i < h; ++i)
             {
-                VideoFilters::averageTwoLines(dest, src1, src2, minLinesize);
+                averageTwoLines(dest, src1, src2, minLinesize);
                 dest += linesizeDest;
                 src1 += linesizeSrc1;
                 src2 += linesizeSrc2;
@@ -0,0 +1,462 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <MotionInterpolator.hpp>
+#include <VideoFilters.hpp>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using namespace std;
+
+constexpr int g_blockSize = 16; // Full resolution luma block size
+constexpr int g_numLevels = 3;
+constexpr int g_coarseRange = 3; // Search range at the coarsest level, +-12 pixels at full resolution
+
+template<int W>
+static inline int sadBlock(const quint8 *__restrict__ a, int linesizeA, const quint8 *__restrict__ b, int linesizeB, int h)
+{
+    int sum = 0;
+    for (int y = 0; y < h; ++y, a += linesizeA, b += linesizeB)
+    {
+        for (int x = 0; x < W; ++x)
+            sum += abs(a[x] - b[x]); // This generates "psadbw" instruction on x86
+    }
+    return sum;
+}
+static inline int sadBlock(const quint8 *__restrict__ a, int linesizeA, const quint8 *__restrict__ b, int linesizeB, int w, int h)
+{
+    switch (w)
+    {
+        case 16:
+            return sadBlock<16>(a, linesizeA, b, linesizeB, h);
+        case 8:
+            return sadBlock<8>(a, linesizeA, b, linesizeB, h);
+        case 4:
+            return sadBlock<4>(a, linesizeA, b, linesizeB, h);
+    }
+    int sum = 0;
+    for (int y = 0; y < h; ++y, a += linesizeA, b += linesizeB)
+    {
+        for (int x = 0; x < w; ++x)
+            sum += abs(a[x] - b[x]);
+    }
+    return sum;
+}
+
+/**/
+
+bool MotionInterpolator::isSupported(const Frame &frame)
+{
+    return !frame.isEmpty() && frame.hasCPUAccess() && frame.isPlannar() && !frame.isRGB() && frame.depth() == 8;
+}
+
+MotionInterpolator::MotionInterpolator()
+{
+    m_threadsPool.setMaxThreadCount(min(QThread::idealThreadCount(), 18));
+}
+MotionInterpolator::~MotionInterpolator()
+{
+}
+
+Frame MotionInterpolator::interpolate(const Frame &prev, const Frame &next, double timeBudget)
+{
+    if (prev.width() != next.width() || prev.height() != next.height() || prev.pixelFormat() != next.pixelFormat())
+        return Frame();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Frame dest = Frame::createEmpty(next, true);
+
+    if (m_quality == Quality::Blend)
+    {
+        clear();
+        blend(prev, next, dest);
+    }
+    else
+    {
+        // The "next" frame of the previous call is usually the "prev" frame now
+        if (m_pyramids[1].frame.constData(0) == prev.constData(0))
+            swap(m_pyramids[0], m_pyramids[1]);
+        buildPyramid(m_pyramids[0], prev);
+        buildPyramid(m_pyramids[1], next);
+
+        m_blocksW = (next.width()  + g_blockSize - 1) / g_blockSize;
+        m_blocksH = (next.height() + g_blockSize - 1) / g_blockSize;
+
+        const int lastLevel = (m_quality == Quality::Full) ? 0 : (m_quality == Quality::Reduced) ? 1 : 2;
+        estimateMotion(g_numLevels - 1, lastLevel);
+        if (lastLevel > 0)
+        {
+            for (auto &&vector : m_vectors)
+            {
+                vector.x <<= lastLevel;
+                vector.y <<= lastLevel;
+            }
+        }
+
+        compensate(prev, next, dest, m_quality != Quality::Coarse);
+    }
+
+    adaptQuality(timer.nsecsElapsed() / 1e9, timeBudget);
+
+    return dest;
+}
+
+void MotionInterpolator::clear()
+{
+    for (auto &&pyramid : m_pyramids)
+        pyramid = Pyramid();
+}
+
+void MotionInterpolator::buildPyramid(Pyramid &pyramid, const Frame &frame)
+{
+    if (!pyramid.frame.isEmpty() && pyramid.frame.constData(0) == frame.constData(0))
+        return;
+
+    pyramid.frame = frame;
+
+    Level &level0 = pyramid.levels[0];
+    level0.buffer.clear();
+    level0.data = frame.constData(0);
+    level0.linesize = frame.linesize(0);
+    level0.w = frame.width(0);
+    level0.h = frame.height(0);
+
+    for (int l = 1; l < g_numLevels; ++l)
+    {
+        const Level &src = pyramid.levels[l - 1];
+        Level &dst = pyramid.levels[l];
+
+        dst.w = max(src.w >> 1, 1);
+        dst.h = max(src.h >> 1, 1);
+        dst.linesize = dst.w;
+        dst.buffer.resize(dst.linesize * dst.h);
+        dst.data = dst.buffer.data();
+
+        runJobs(dst.h, [&](const int jobId, const int jobsCount) {
+            const int yBegin = dst.h * jobId / jobsCount;
+            const int yEnd = dst.h * (jobId + 1) / jobsCount;
+            for (int y = yBegin; y < yEnd; ++y)
+            {
+                const quint8 *src0 = src.data + min(y * 2 + 0, src.h - 1) * src.linesize;
+                const quint8 *src1 = src.data + min(y * 2 + 1, src.h - 1) * src.linesize;
+                quint8 *dstLine = dst.buffer.data() + y * dst.linesize;
+                for (int x = 0; x < dst.w; ++x)
+                {
+                    const int x0 = min(x * 2 + 0, src.w - 1);
+                    const int x1 = min(x * 2 + 1, src.w - 1);
+                    dstLine[x] = (src0[x0] + src0[x1] + src1[x0] + src1[x1] + 2) >> 2;
+                }
+            }
+        });
+    }
+}
+
+void MotionInterpolator::estimateMotion(int firstLevel, int lastLevel)
+{
+    m_vectors.assign(m_blocksW * m_blocksH, Vector{0, 0});
+
+    for (int l = firstLevel; l >= lastLevel; --l)
+    {
+        const bool hasParent = (l != firstLevel);
+        if (hasParent)
+        {
+            m_parentVectors.swap(m_vectors);
+            m_vectors.resize(m_parentVectors.size());
+        }
+
+        const Level &prev = m_pyramids[0].levels[l];
+        const Level &next = m_pyramids[1].levels[l];
+
+        const int blockSize = g_blockSize >> l;
+        const int lambda = max((blockSize * blockSize) >> 5, 1);
+
+        runJobs(m_blocksH, [&](const int jobId, const int jobsCount) {
+            const int byBegin = m_blocksH * jobId / jobsCount;
+            const int byEnd = m_blocksH * (jobId + 1) / jobsCount;
+            for (int by = byBegin; by < byEnd; ++by)
+            {
+                for (int bx = 0; bx < m_blocksW; ++bx)
+                {
+                    const int idx = by * m_blocksW + bx;
+
+                    const int x0 = bx * blockSize;
+                    const int y0 = by * blockSize;
+                    const int w = min(blockSize, prev.w - x0);
+                    const int h = min(blockSize, prev.h - y0);
+
+                    Vector base {0, 0};
+                    if (hasParent)
+                        base = {m_parentVectors[idx].x * 2, m_parentVectors[idx].y * 2};
+
+                    if (w <= 0 || h <= 0)
+                    {
+                        m_vectors[idx] = base;
+                        continue;
+                    }
+
+                    // Symmetric search: the block in the interpolated frame moves by "-v" in "prev" and "+v" in "next"
+                    Vector best {0, 0};
+                    int bestCost = numeric_limits<int>::max();
+                    auto tryVector = [&](int vx, int vy) {
+                        const int ax = abs(vx), ay = abs(vy);
+                        if (x0 - ax < 0 || y0 - ay < 0 || x0 + w + ax > prev.w || y0 + h + ay > prev.h)
+                            return;
+                        const int cost = sadBlock(
+                            prev.data + (y0 - vy) * prev.linesize + (x0 - vx), prev.linesize,
+                            next.data + (y0 + vy) * next.linesize + (x0 + vx), next.linesize,
+                            w, h
+                        ) + lambda * (ax + ay);
+                        if (cost < bestCost)
+                        {
+                            bestCost = cost;
+                            best = {vx, vy};
+                        }
+                    };
+
+                    tryVector(0, 0);
+                    if (!hasParent)
+                    {
+                        for (int vy = -g_coarseRange; vy <= g_coarseRange; ++vy)
+                        {
+                            for (int vx = -g_coarseRange; vx <= g_coarseRange; ++vx)
+                                tryVector(vx, vy);
+                        }
+                    }
+                    else
+                    {
+                        for (int dy = -1; dy <= 1; ++dy)
+                        {
+                            for (int dx = -1; dx <= 1; ++dx)
+                                tryVector(base.x + dx, base.y + dy);
+                        }
+                    }
+
+                    m_vectors[idx] = best;
+                }
+            }
+        });
+    }
+}
+
+void MotionInterpolator::compensate(const Frame &prev, const Frame &next, Frame &dest, bool overlapped)
+{
+    vector<Vector> planeVectors(m_vectors.size());
+    vector<int> colBlock0, colBlock1, colWeight, segments;
+
+    for (int p = 0; p < dest.numPlanes(); ++p)
+    {
+        const int shiftW = (p == 0) ? 0 : dest.chromaShiftW();
+        const int shiftH = (p == 0) ? 0 : dest.chromaShiftH();
+        const int blockW = g_blockSize >> shiftW;
+        const int blockH = g_blockSize >> shiftH;
+
+        const int w = dest.width(p);
+        const int h = dest.height(p);
+
+        const quint8 *prevData = prev.constData(p);
+        const quint8 *nextData = next.constData(p);
+        const int prevLinesize = prev.linesize(p);
+        const int nextLinesize = next.linesize(p);
+
+        quint8 *destData = dest.data(p);
+        const int destLinesize = dest.linesize(p);
+
+        for (size_t i = 0; i < m_vectors.size(); ++i)
+            planeVectors[i] = {m_vectors[i].x / (1 << shiftW), m_vectors[i].y / (1 << shiftH)};
+
+        // Overlapped blocks are blended bilinearly between the neighbouring block centers
+        auto getBlock = [&](int pos, int blockSize, int numBlocks, int &block0, int &block1, int &weight) {
+            if (overlapped)
+            {
+                const int t = pos - blockSize / 2;
+                const int b = (t < 0) ? -1 : t / blockSize;
+                block0 = qBound(0, b, numBlocks - 1);
+                block1 = qBound(0, b + 1, numBlocks - 1);
+                weight = (t - b * blockSize) * 256 / blockSize;
+            }
+            else
+            {
+                block0 = block1 = min(pos / blockSize, numBlocks - 1);
+                weight = 0;
+            }
+        };
+
+        colBlock0.resize(w);
+        colBlock1.resize(w);
+        colWeight.resize(w);
+        segments.clear();
+        for (int x = 0; x < w; ++x)
+        {
+            getBlock(x, blockW, m_blocksW, colBlock0[x], colBlock1[x], colWeight[x]);
+            if (x == 0 || colBlock0[x] != colBlock0[x - 1] || colBlock1[x] != colBlock1[x - 1])
+                segments.push_back(x);
+        }
+        segments.push_back(w);
+
+        runJobs(h, [&](const int jobId, const int jobsCount) {
+            auto predict = [&](const Vector &v, int x, int y) {
+                const int xp = qBound(0, x - v.x, w - 1);
+                const int yp = qBound(0, y - v.y, h - 1);
+                const int xn = qBound(0, x + v.x, w - 1);
+                const int yn = qBound(0, y + v.y, h - 1);
+                return (prevData[yp * prevLinesize + xp] + nextData[yn * nextLinesize + xn] + 1) >> 1;
+            };
+
+            const int yBegin = h * jobId / jobsCount;
+            const int yEnd = h * (jobId + 1) / jobsCount;
+            for (int y = yBegin; y < yEnd; ++y)
+            {
+                int rowBlock0, rowBlock1, wy;
+                getBlock(y, blockH, m_blocksH, rowBlock0, rowBlock1, wy);
+
+                const Vector *vectors0 = planeVectors.data() + rowBlock0 * m_blocksW;
+                const Vector *vectors1 = planeVectors.data() + rowBlock1 * m_blocksW;
+
+                quint8 *destLine = destData + y * destLinesize;
+
+                // Vectors are constant within a segment, so most of it can be processed without clamping
+                for (size_t s = 0; s + 1 < segments.size(); ++s)
+                {
+                    const int xBegin = segments[s];
+                    const int xEnd = segments[s + 1];
+
+                    const Vector *v[4] = {
+                        &vectors0[colBlock0[xBegin]],
+                        &vectors0[colBlock1[xBegin]],
+                        &vectors1[colBlock0[xBegin]],
+                        &vectors1[colBlock1[xBegin]],
+                    };
+
+                    bool inside = true;
+                    for (auto &&vec : v)
+                    {
+                        const int ax = abs(vec->x), ay = abs(vec->y);
+                        inside &= (xBegin - ax >= 0 && xEnd + ax <= w && y - ay >= 0 && y + ay < h);
+                    }
+
+                    if (!inside)
+                    {
+                        for (int x = xBegin; x < xEnd; ++x)
+                        {
+                            const int wx = colWeight[x];
+                            const int top    = predict(*v[0], x, y) * (256 - wx) + predict(*v[1], x, y) * wx;
+                            const int bottom = predict(*v[2], x, y) * (256 - wx) + predict(*v[3], x, y) * wx;
+                            destLine[x] = (top * (256 - wy) + bottom * wy + 32768) >> 16;
+                        }
+                        continue;
+                    }
+
+                    const quint8 *prevLines[4], *nextLines[4];
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        prevLines[i] = prevData + (y - v[i]->y) * prevLinesize - v[i]->x;
+                        nextLines[i] = nextData + (y + v[i]->y) * nextLinesize + v[i]->x;
+                    }
+
+                    const bool sameVectors =
+                        v[0]->x == v[1]->x && v[0]->x == v[2]->x && v[0]->x == v[3]->x &&
+                        v[0]->y == v[1]->y && v[0]->y == v[2]->y && v[0]->y == v[3]->y
+                    ;
+                    if (sameVectors)
+                    {
+                        VideoFilters::averageTwoLines(destLine + xBegin, prevLines[0] + xBegin, nextLines[0] + xBegin, xEnd - xBegin);
+                        continue;
+                    }
+
+                    for (int x = xBegin; x < xEnd; ++x)
+                    {
+                        int pred[4];
+                        for (int i = 0; i < 4; ++i)
+                            pred[i] = (prevLines[i][x] + nextLines[i][x] + 1) >> 1;
+                        const int wx = colWeight[x];
+                        const int top    = pred[0] * (256 - wx) + pred[1] * wx;
+                        const int bottom = pred[2] * (256 - wx) + pred[3] * wx;
+                        destLine[x] = (top * (256 - wy) + bottom * wy + 32768) >> 16;
+                    }
+                }
+            }
+        });
+    }
+}
+void MotionInterpolator::blend(const Frame &prev, const Frame &next, Frame &dest)
+{
+    for (int p = 0; p < dest.numPlanes(); ++p)
+    {
+        const int w = dest.width(p);
+        const int h = dest.height(p);
+        runJobs(h, [&](const int jobId, const int jobsCount) {
+            const int yBegin = h * jobId / jobsCount;
+            const int yEnd = h * (jobId + 1) / jobsCount;
+            for (int y = yBegin; y < yEnd; ++y)
+            {
+                VideoFilters::averageTwoLines(
+                    dest.data(p) + y * dest.linesize(p),
+                    prev.constData(p) + y * prev.linesize(p),
+                    next.constData(p) + y * next.linesize(p),
+                    w
+                );
+            }
+        });
+    }
+}
+
+void MotionInterpolator::adaptQuality(double elapsed, double timeBudget)
+{
+    if (elapsed > timeBudget)
+    {
+        if (m_quality != Quality::Blend)
+            m_quality = static_cast<Quality>(static_cast<int>(m_quality) + 1);
+        m_fastFrames = 0;
+    }
+    else if (m_quality != Quality::Full && elapsed < timeBudget / 3.0)
+    {
+        // Go back to better quality only if it was fast enough for a while
+        if (++m_fastFrames >= 50)
+        {
+            m_quality = static_cast<Quality>(static_cast<int>(m_quality) - 1);
+            m_fastFrames = 0;
+        }
+    }
+    else
+    {
+        m_fastFrames = 0;
+    }
+}
+
+void MotionInterpolator::runJobs(int maxJobs, const function<void(int jobId, int jobsCount)> &fn)
+{
+    const int jobsCount = max(min(m_threadsPool.maxThreadCount(), maxJobs), 1);
+
+    vector<QFuture<void>> threads;
+    threads.reserve(jobsCount - 1);
+
+    for (int i = 1; i < jobsCount; ++i)
+        threads.push_back(QtConcurrent::run(&m_threadsPool, fn, i, jobsCount));
+    fn(0, jobsCount);
+
+    for (auto &&thread : threads)
+        thread.waitForFinished();
+}
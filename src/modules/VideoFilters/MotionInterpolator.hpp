@@ -0,0 +1,88 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Frame.hpp>
+
+#include <QThreadPool>
+
+#include <functional>
+#include <vector>
+
+/* Motion-compensated interpolation of a frame half way between two frames (8-bit planar YUV) */
+class MotionInterpolator
+{
+public:
+    enum class Quality
+    {
+        Full,    // 3-level hierarchical motion estimation, overlapped block compensation
+        Reduced, // Motion estimation without the full resolution refinement
+        Coarse,  // Coarsest level motion estimation, plain block compensation
+        Blend,   // No motion compensation, average of both frames
+    };
+
+    static bool isSupported(const Frame &frame);
+
+public:
+    MotionInterpolator();
+    ~MotionInterpolator();
+
+    // Quality is lowered when interpolation takes longer than "timeBudget" seconds
+    Frame interpolate(const Frame &prev, const Frame &next, double timeBudget);
+
+    void clear();
+
+private:
+    struct Vector
+    {
+        int x, y;
+    };
+    struct Level
+    {
+        std::vector<quint8> buffer;
+        const quint8 *data = nullptr;
+        int linesize = 0;
+        int w = 0, h = 0;
+    };
+    struct Pyramid
+    {
+        Frame frame;
+        Level levels[3];
+    };
+
+    void buildPyramid(Pyramid &pyramid, const Frame &frame);
+    void estimateMotion(int firstLevel, int lastLevel);
+    void compensate(const Frame &prev, const Frame &next, Frame &dest, bool overlapped);
+    void blend(const Frame &prev, const Frame &next, Frame &dest);
+
+    void adaptQuality(double elapsed, double timeBudget);
+
+    void runJobs(int maxJobs, const std::function<void(int jobId, int jobsCount)> &fn);
+
+private:
+    QThreadPool m_threadsPool;
+
+    Quality m_quality = Quality::Full;
+    int m_fastFrames = 0;
+
+    Pyramid m_pyramids[2]; // prev, next
+
+    int m_blocksW = 0, m_blocksH = 0;
+    std::vector<Vector> m_vectors, m_parentVectors;
+};
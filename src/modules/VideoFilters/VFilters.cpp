@@ -34,6 +34,7 @@ VFilters::VFilters() :
     init("FPSDoubler/MinFPS", 21.000);
     init("FPSDoubler/MaxFPS", 29.990);
     init("FPSDoubler/OnlyFullScreen", true);
+    init("FPSDoubler/MotionInterpolation", false);
 
     connect(&QMPlay2Core, &QMPlay2CoreClass::fullScreenChanged,
             this, [this](bool fs) {
@@ -102,6 +103,7 @@ ModuleSettingsWidget::ModuleSettingsWidget(Module &module)
     , m_minFpsSpinBox(new QDoubleSpinBox)
     , m_maxFpsSpinBox(new QDoubleSpinBox)
     , m_onlyFullScreenCheckBox(new QCheckBox(tr("Only in full screen")))
+    , m_motionInterpolationCheckBox(new QCheckBox(tr("Motion-compensated interpolation")))
 {
     m_minFpsSpinBox->setDecimals(3);
     m_maxFpsSpinBox->setDecimals(3);
@@ -120,10 +122,14 @@ ModuleSettingsWidget::ModuleSettingsWidget(Module &module)
 
     m_onlyFullScreenCheckBox->setChecked(sets().getBool("FPSDoubler/OnlyFullScreen"));
 
+    m_motionInterpolationCheckBox->setToolTip(tr("Creates the extra frames from motion between neighbour frames instead of repeating them. Works only with software decoding."));
+    m_motionInterpolationCheckBox->setChecked(sets().getBool("FPSDoubler/MotionInterpolation"));
+
     auto fpsDoublerLayout = new QFormLayout;
     fpsDoublerLayout->addRow(tr("Minimum:"), m_minFpsSpinBox);
     fpsDoublerLayout->addRow(tr("Maximum:"), m_maxFpsSpinBox);
     fpsDoublerLayout->addRow(m_onlyFullScreenCheckBox);
+    fpsDoublerLayout->addRow(m_motionInterpolationCheckBox);
 
     auto fpsDoublerGroup = new QGroupBox(FPSDoublerName);
     fpsDoublerGroup->setLayout(fpsDoublerLayout);
@@ -142,4 +148,5 @@ void ModuleSettingsWidget::saveSettings()
         sets().set("FPSDoubler/MaxFPS", max);
     }
     sets().set("FPSDoubler/OnlyFullScreen", m_onlyFullScreenCheckBox->isChecked());
+    sets().set("FPSDoubler/MotionInterpolation", m_motionInterpolationCheckBox->isChecked());
 }
@@ -56,4 +56,5 @@ private:
     QDoubleSpinBox *const m_minFpsSpinBox;
     QDoubleSpinBox *const m_maxFpsSpinBox;
     QCheckBox *const m_onlyFullScreenCheckBox;
+    QCheckBox *const m_motionInterpolationCheckBox;
 };
@@ -34,12 +34,15 @@ using namespace std;
 
 /* Yadif algo */
 
-template<int j>
-static inline void check(const quint8 *const curr,
+// "T" is the sample type, "step" is the distance between horizontally adjacent
+// samples of the same component (2 for interleaved chroma in semi-planar formats).
+
+template<typename T, int step, int j>
+static inline void check(const T *const curr,
                          const int prefs, const int mrefs,
                          int &spatialScore, int &spatialPred)
 {
-    const int score = abs(curr[mrefs-1+j] - curr[prefs-1-j]) + abs(curr[mrefs+j] - curr[prefs-j]) + abs(curr[mrefs+1+j] - curr[prefs+1-j]);
+    const int score = abs(curr[mrefs+(-1+j)*step] - curr[prefs+(-1-j)*step]) + abs(curr[mrefs+j*step] - curr[prefs-j*step]) + abs(curr[mrefs+(1+j)*step] - curr[prefs+(1-j)*step]);
     if (score < spatialScore)
     {
         // This must be in a separate condition w/o assigning condition to a variable,
@@ -48,28 +51,28 @@ static inline void check(const quint8 *const curr,
     }
     if (score < spatialScore)
     {
-        spatialPred = (curr[mrefs+j] + curr[prefs-j]) >> 1;
+        spatialPred = (curr[mrefs+j*step] + curr[prefs-j*step]) >> 1;
         switch (j)
         {
             case -1:
-                check<-2>(curr, prefs, mrefs, spatialScore, spatialPred);
+                check<T, step, -2>(curr, prefs, mrefs, spatialScore, spatialPred);
                 break;
             case +1:
-                check<+2>(curr, prefs, mrefs, spatialScore, spatialPred);
+                check<T, step, +2>(curr, prefs, mrefs, spatialScore, spatialPred);
                 break;
             default:
                 break;
         }
     }
 }
-template<bool isNotEdge, bool spatialCheck>
-static inline void filterLine(quint8 *dest, const void *const destEnd,
-                              const quint8 *__restrict__ prev, const quint8 *__restrict__ curr, const quint8 *__restrict__ next,
+template<typename T, int step, bool isNotEdge, bool spatialCheck>
+static inline void filterLine(T *dest, const void *const destEnd,
+                              const T *__restrict__ prev, const T *__restrict__ curr, const T *__restrict__ next,
                               const qptrdiff prefs, const qptrdiff mrefs,
                               const bool filterParity)
 {
-    const quint8 *prev2 = filterParity ? prev : curr;
-    const quint8 *next2 = filterParity ? curr : next;
+    const T *prev2 = filterParity ? prev : curr;
+    const T *next2 = filterParity ? curr : next;
     while (dest != destEnd)
     {
         const int c = curr[mrefs];
@@ -85,9 +88,9 @@ static inline void filterLine(quint8 *dest, const void *const destEnd,
         /* Reads 3 pixels to the left/right */
         if (isNotEdge)
         {
-            int spatialScore = abs(curr[mrefs-1] - curr[prefs-1]) + abs(c - e) + abs(curr[mrefs+1] - curr[prefs+1]) - 1;
-            check<-1>(curr, prefs, mrefs, spatialScore, spatialPred);
-            check<+1>(curr, prefs, mrefs, spatialScore, spatialPred);
+            int spatialScore = abs(curr[mrefs-step] - curr[prefs-step]) + abs(c - e) + abs(curr[mrefs+step] - curr[prefs+step]) - 1;
+            check<T, step, -1>(curr, prefs, mrefs, spatialScore, spatialPred);
+            check<T, step, +1>(curr, prefs, mrefs, spatialScore, spatialPred);
         }
 
         /* Spatial interlacing check */
@@ -114,116 +117,102 @@ static inline void filterLine(quint8 *dest, const void *const destEnd,
     }
 }
 
+template<typename T, int step, bool spatialCheck>
+static inline void filterLineWithEdges(T *dest, const int w,
+                                       const T *prev, const T *curr, const T *next,
+                                       const qptrdiff prefs, const qptrdiff mrefs,
+                                       const bool filterParity)
+{
+    constexpr int edge = 3 * step;
+    filterLine<T, step, false, spatialCheck>
+    (
+        dest,
+        dest + edge,
+        prev,
+        curr,
+        next,
+        prefs,
+        mrefs,
+        filterParity
+    );
+    filterLine<T, step, true, spatialCheck>
+    (
+        dest  + edge,
+        dest  + w - edge,
+        prev  + edge,
+        curr  + edge,
+        next  + edge,
+        prefs,
+        mrefs,
+        filterParity
+    );
+    filterLine<T, step, false, spatialCheck>
+    (
+        dest  + w - edge,
+        dest  + w,
+        prev  + w - edge,
+        curr  + w - edge,
+        next  + w - edge,
+        prefs,
+        mrefs,
+        filterParity
+    );
+}
+
+template<typename T, int step>
 static void filterSlice(const int plane, const int parity, const int tff, const bool spatialCheck,
                         Frame &destFrame, const Frame &prevFrame, const Frame &currFrame, const Frame &nextFrame,
                         const int jobId, const int jobsCount)
 {
-    const int w = currFrame.width(plane);
+    const int w = currFrame.width(plane) * step;
     const int h = currFrame.height(plane);
 
     const int sliceStart   = (h *  jobId   ) / jobsCount;
     const int sliceEnd     = (h * (jobId+1)) / jobsCount;
-    const int refs         = currFrame.linesize(plane);
-    const int destLinesize = destFrame.linesize(plane);
+    const int refs         = currFrame.linesize(plane) / sizeof(T);
+    const int destLinesize = destFrame.linesize(plane) / sizeof(T);
     const int filterParity = parity ^ tff;
 
-    const quint8 *const prevData = prevFrame.constData(plane);
-    const quint8 *const currData = currFrame.constData(plane);
-    const quint8 *const nextData = nextFrame.constData(plane);
-    quint8 *const destData = destFrame.data(plane);
+    const T *const prevData = reinterpret_cast<const T *>(prevFrame.constData(plane));
+    const T *const currData = reinterpret_cast<const T *>(currFrame.constData(plane));
+    const T *const nextData = reinterpret_cast<const T *>(nextFrame.constData(plane));
+    T *const destData = reinterpret_cast<T *>(destFrame.data(plane));
 
     for (int y = sliceStart; y < sliceEnd; ++y)
     {
-        const quint8 *curr  = &currData[y * refs];
-        quint8 *dest = &destData[y * destLinesize];
+        const T *curr  = &currData[y * refs];
+        T *dest = &destData[y * destLinesize];
         if ((y ^ parity) & 1)
         {
-            const quint8 *prev  = &prevData[y * refs];
-            const quint8 *next  = &nextData[y * refs];
+            const T *prev  = &prevData[y * refs];
+            const T *next  = &nextData[y * refs];
 
             const int prefs = (y + 1) < h ? refs : -refs;
             const int mrefs = y ? -refs : refs;
 
             if (spatialCheck && y != 1 && y + 2 != h)
-            {
-                filterLine<false, true>
-                (
-                    dest,
-                    dest + 3,
-                    prev,
-                    curr,
-                    next,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-                filterLine<true, true>
-                (
-                    dest  + 3,
-                    dest  + w - 3,
-                    prev  + 3,
-                    curr  + 3,
-                    next  + 3,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-                filterLine<false, true>
-                (
-                    dest  + w - 3,
-                    dest  + w,
-                    prev  + w - 3,
-                    curr  + w - 3,
-                    next  + w - 3,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-            }
+                filterLineWithEdges<T, step, true>(dest, w, prev, curr, next, prefs, mrefs, filterParity);
             else
-            {
-                filterLine<false, false>
-                (
-                    dest,
-                    dest + 3,
-                    prev,
-                    curr,
-                    next,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-                filterLine<true, false>
-                (
-                    dest  + 3,
-                    dest  + w - 3,
-                    prev  + 3,
-                    curr  + 3,
-                    next  + 3,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-                filterLine<false, false>
-                (
-                    dest  + w - 3,
-                    dest  + w,
-                    prev  + w - 3,
-                    curr  + w - 3,
-                    next  + w - 3,
-                    prefs,
-                    mrefs,
-                    filterParity
-                );
-            }
+                filterLineWithEdges<T, step, false>(dest, w, prev, curr, next, prefs, mrefs, filterParity);
         }
         else
         {
-            memcpy(dest, curr, w);
+            memcpy(dest, curr, w * sizeof(T));
         }
     }
 }
 
+template<typename T>
+static void filterPlane(const int plane, const bool interleaved, const int parity, const int tff, const bool spatialCheck,
+                        Frame &destFrame, const Frame &prevFrame, const Frame &currFrame, const Frame &nextFrame,
+                        const int jobId, const int jobsCount)
+{
+    if (interleaved)
+        filterSlice<T, 2>(plane, parity, tff, spatialCheck, destFrame, prevFrame, currFrame, nextFrame, jobId, jobsCount);
+    else
+        filterSlice<T, 1>(plane, parity, tff, spatialCheck, destFrame, prevFrame, currFrame, nextFrame, jobId, jobsCount);
+}
+
 /* Yadif deint filter */
 
 YadifDeint::YadifDeint(bool doubler, bool spatialCheck)
@@ -231,6 +220,7 @@ YadifDeint::YadifDeint(bool doubler, bool spatialCheck)
     , m_doubler(doubler)
     , m_spatialCheck(spatialCheck)
 {
+    addGenericCPUPixelFormats();
     m_threadsPool.setMaxThreadCount(min(QThread::idealThreadCount(), 18));
     addParam("DeinterlaceFlags");
     addParam("W");
@@ -249,13 +239,17 @@ bool YadifDeint::filter(QQueue<Frame> &framesQueue)
         Frame destFrame = getNewFrame(currFrame);
         destFrame.setNoInterlaced();
 
+        const bool is16bit = (currFrame.depth() > 8);
+        const int numPlanes = currFrame.numPlanes();
+        const bool semiPlanar = (numPlanes == 2 && !currFrame.isGray());
+
         auto doFilter = [&](const int jobId, const int jobsCount) {
             const bool tff = isTopFieldFirst(currFrame);
-            for (int p = 0; p < 3; ++p)
+            for (int p = 0; p < numPlanes; ++p)
             {
-                filterSlice
+                (is16bit ? filterPlane<quint16> : filterPlane<quint8>)
                 (
-                    p,
+                    p, semiPlanar && p == 1,
                     m_secondFrame == tff, tff,
                     m_spatialCheck,
                     destFrame, prevFrame, currFrame, nextFrame,
@@ -41,3 +41,13 @@ int AudioFilter::bufferedSamples() const
 }
 void AudioFilter::clearBuffers()
 {}
+
+bool AudioFilter::canBeFused() const
+{
+    return false;
+}
+void AudioFilter::filterSamples(float *samples, int size)
+{
+    Q_UNUSED(samples)
+    Q_UNUSED(size)
+}
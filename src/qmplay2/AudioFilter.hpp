@@ -31,4 +31,9 @@ public:
     virtual int bufferedSamples() const;
     virtual void clearBuffers();
     virtual double filter(QByteArray &data, bool flush = false) = 0; //returns delay in [s]
+
+    // Filters which process audio frames in order, without delay and without changing the data size,
+    // can be fused with neighbouring ones, so the whole chain runs block by block in a single pass.
+    virtual bool canBeFused() const;
+    virtual void filterSamples(float *samples, int size);
 };
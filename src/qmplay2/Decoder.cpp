@@ -37,7 +37,8 @@ class QMPlay2DummyDecoder : public Decoder
 Decoder *Decoder::create(
     StreamInfo &streamInfo,
     const QStringList &modNames,
-    QString *modNameOutput)
+    QString *modNameOutput,
+    bool auxiliary)
 {
     auto maybeRestoreCodecName = [&] {
         if (!streamInfo.codec_name_backup.isEmpty())
@@ -77,6 +78,7 @@ Decoder *Decoder::create(
         if (!decoder)
             continue;
         maybeRestoreCodecName();
+        decoder->m_auxiliary = auxiliary;
         if (decoder->open(streamInfo))
         {
             if (modNameOutput)
@@ -38,7 +38,8 @@ public:
     static Decoder *create(
         StreamInfo &streamInfo,
         const QStringList &modNames,
-        QString *modNameOutput
+        QString *modNameOutput,
+        bool auxiliary = false
     );
 
     virtual QString name() const = 0;
@@ -66,4 +67,8 @@ public:
 
 private:
     virtual bool open(StreamInfo &streamInfo) = 0;
+
+protected:
+    // Decoder is not used for playback (e.g. seek preview), it shouldn't take resources from it
+    bool m_auxiliary = false;
 };
@@ -1145,6 +1145,22 @@ QString Functions::getSeqFile(const QString &dir, const QString &ext, const QStr
     return QString("QMPlay2_%1_%2%3").arg(frag).arg(++num, 5, 10, QChar('0')).arg(ext);
 }
 
+qint64 Functions::evictOldFiles(const QString &dir, qint64 maxSize)
+{
+    const QFileInfoList entries = QDir(dir).entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 totalSize = 0;
+    for (const QFileInfo &entry : entries)
+        totalSize += entry.size();
+    for (const QFileInfo &entry : entries)
+    {
+        if (totalSize <= maxSize)
+            break;
+        if (QFile::remove(entry.filePath()))
+            totalSize -= entry.size();
+    }
+    return totalSize;
+}
+
 std::pair<QString, QString> Functions::determineExtFmt(const QList<StreamInfo *> &streamsInfo)
 {
     QString ext("mkv");
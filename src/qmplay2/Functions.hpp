@@ -168,6 +168,9 @@ namespace Functions
 
     QMPLAY2SHAREDLIB_EXPORT QString getSeqFile(const QString &dir, const QString &ext, const QString &frag);
 
+    // Removes the least recently modified files until the directory size fits in "maxSize", returns the new size
+    QMPLAY2SHAREDLIB_EXPORT qint64 evictOldFiles(const QString &dir, qint64 maxSize);
+
     QMPLAY2SHAREDLIB_EXPORT std::pair<QString, QString> determineExtFmt(const QList<StreamInfo *> &streamsInfo);
 
     QMPLAY2SHAREDLIB_EXPORT void getUserDoubleValue(QWidget *parent, const QString &title, const QString &label, double value, double min, double max, int decimals, double step, const std::function<void(double)> &onChanged);
@@ -18,6 +18,7 @@
 
 #include <NetworkAccess.hpp>
 
+#include <NetworkCache.hpp>
 #include <QMPlay2Core.hpp>
 #include <Functions.hpp>
 
@@ -29,8 +30,14 @@ extern "C"
     #include <libavutil/opt.h>
 }
 
+#include <QWaitCondition>
 #include <QThread>
 #include <QMutex>
+#include <QHash>
+#include <QUrl>
+
+#include <atomic>
+#include <list>
 
 static int interruptCB(bool *m_status)
 {
@@ -49,12 +56,97 @@ static bool doSleep(bool &aborted, int retryInterval)
 
 /**/
 
+/* Limits the number of simultaneous connections, waiting requests are served by priority */
+class NetworkSlots
+{
+    static constexpr int s_maxConnections = 8;
+    static constexpr int s_maxHostConnections = 4;
+
+    struct Waiter
+    {
+        const QString &host;
+        const std::atomic_int &priority;
+        quint64 seq;
+    };
+
+public:
+    static NetworkSlots &instance()
+    {
+        static NetworkSlots networkSlots;
+        return networkSlots;
+    }
+
+    bool acquire(const QString &host, const std::atomic_int &priority, const bool &aborted)
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_waiters.insert(m_waiters.end(), {host, priority, m_seq++});
+        while (!aborted && !canRun(*it))
+            m_cond.wait(&m_mutex, 100); // Timeout to check the "aborted" flag
+        m_waiters.erase(it);
+        if (aborted)
+        {
+            m_cond.wakeAll();
+            return false;
+        }
+        ++m_running;
+        ++m_hostRunning[host];
+        m_cond.wakeAll(); // The next waiter might fit into the remaining slots
+        return true;
+    }
+    void release(const QString &host)
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_running;
+        auto it = m_hostRunning.find(host);
+        if (--it.value() == 0)
+            m_hostRunning.erase(it);
+        m_cond.wakeAll();
+    }
+
+    void priorityChanged()
+    {
+        m_cond.wakeAll();
+    }
+
+private:
+    inline bool hasFreeSlot(const QString &host) const
+    {
+        return (m_running < s_maxConnections && m_hostRunning.value(host) < s_maxHostConnections);
+    }
+    bool canRun(const Waiter &waiter) const
+    {
+        if (!hasFreeSlot(waiter.host))
+            return false;
+        for (const Waiter &other : m_waiters)
+        {
+            if (&other == &waiter || !hasFreeSlot(other.host))
+                continue;
+            const int priority = waiter.priority, otherPriority = other.priority;
+            if (otherPriority > priority || (otherPriority == priority && other.seq < waiter.seq))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    std::list<Waiter> m_waiters;
+    QHash<QString, int> m_hostRunning;
+    int m_running = 0;
+    quint64 m_seq = 0;
+};
+
+/**/
+
 struct NetworkAccessParams
 {
     QByteArray customUserAgent;
     int maxSize = INT_MAX;
     int retries = 1;
     int retryInterval = NetworkAccess::s_defaultRetryInterval;
+    int priority = 0;
+    bool cached = false;
 };
 
 /**/
@@ -71,6 +163,8 @@ public:
         m_maxSize(params.maxSize),
         m_retries(params.retries),
         m_retryInterval(params.retryInterval),
+        m_priority(params.priority),
+        m_cached(params.cached && postData.isNull()),
         m_ctx(nullptr),
         m_error(NetworkReply::Error::Ok),
         m_aborted(false),
@@ -88,6 +182,8 @@ public:
     const int m_maxSize;
     int m_retries;
     int m_retryInterval;
+    std::atomic_int m_priority;
+    const bool m_cached;
 
     AVIOContext *m_ctx;
     QByteArray m_cookies;
@@ -111,135 +207,177 @@ private:
     {
         const QString scheme = Functions::getUrlScheme(m_url);
         if (scheme.isEmpty() || scheme == "file")
+        {
             m_error = NetworkReply::Error::UnsupportedScheme;
+        }
+        else if (!m_cached)
+        {
+            download(nullptr);
+        }
         else
         {
-            AVIOInterruptCB interruptCB = {(int(*)(void*))::interruptCB, m_status};
+            QByteArray cacheData;
+            switch (NetworkCache::instance().lookup(m_url, cacheData, m_aborted))
+            {
+                case NetworkCache::Lookup::Hit:
+                    m_dataMutex.lock();
+                    m_data = cacheData;
+                    m_dataMutex.unlock();
+                    break;
+                case NetworkCache::Lookup::Miss:
+                    download(&cacheData);
+                    NetworkCache::instance().finishDownload(m_url, cacheData, m_error == NetworkReply::Error::Ok && !m_aborted);
+                    break;
+                case NetworkCache::Lookup::Aborted:
+                    break;
+            }
+        }
 
-            do
+        m_networkReplyMutex.lock();
+        if (m_networkReply)
+            emit m_networkReply->finished();
+        m_networkReplyMutex.unlock();
+    }
+
+    void download(QByteArray *cacheData)
+    {
+        const QString host = QUrl(m_url).host();
+        if (!NetworkSlots::instance().acquire(host, m_priority, m_aborted))
+            return;
+
+        AVIOInterruptCB interruptCB = {(int(*)(void*))::interruptCB, m_status};
+
+        do
+        {
+            AVDictionary *options = nullptr;
+            const QByteArray url = Functions::prepareFFmpegUrl(m_url, options, true, m_rawHeaders.isEmpty(), m_rawHeaders.isEmpty(), false, m_customUserAgent).toUtf8();
+            av_dict_set(&options, "seekable", "0", 0);
+            if (!m_postData.isNull())
             {
-                AVDictionary *options = nullptr;
-                const QByteArray url = Functions::prepareFFmpegUrl(m_url, options, true, m_rawHeaders.isEmpty(), m_rawHeaders.isEmpty(), false, m_customUserAgent).toUtf8();
-                av_dict_set(&options, "seekable", "0", 0);
-                if (!m_postData.isNull())
-                {
-                    av_dict_set(&options, "method", "POST", 0);
-                    if (!m_postData.isEmpty())
-                        av_dict_set(&options, "post_data", m_postData.toHex(), 0);
-                }
-                if (!m_rawHeaders.isEmpty())
-                    av_dict_set(&options, "headers", m_rawHeaders, 0);
+                av_dict_set(&options, "method", "POST", 0);
+                if (!m_postData.isEmpty())
+                    av_dict_set(&options, "post_data", m_postData.toHex(), 0);
+            }
+            if (!m_rawHeaders.isEmpty())
+                av_dict_set(&options, "headers", m_rawHeaders, 0);
 
-                const int ret = avio_open2(&m_ctx, url, AVIO_FLAG_READ | AVIO_FLAG_DIRECT, &interruptCB, &options);
-                if (ret >= 0)
-                {
-                    m_error = NetworkReply::Error::Ok;
+            const int ret = avio_open2(&m_ctx, url, AVIO_FLAG_READ | AVIO_FLAG_DIRECT, &interruptCB, &options);
+            if (ret >= 0)
+            {
+                m_error = NetworkReply::Error::Ok;
+                break;
+            }
+            switch (ret)
+            {
+                case AVERROR_HTTP_BAD_REQUEST:
+                    m_error = NetworkReply::Error::Connection400;
                     break;
-                }
-                switch (ret)
+                case AVERROR_HTTP_UNAUTHORIZED:
+                    m_error = NetworkReply::Error::Connection401;
+                    break;
+                case AVERROR_HTTP_FORBIDDEN:
+                    m_error = NetworkReply::Error::Connection403;
+                    break;
+                case AVERROR_HTTP_NOT_FOUND:
+                    m_error = NetworkReply::Error::Connection404;
+                    break;
+                case AVERROR_HTTP_OTHER_4XX:
+                    m_error = NetworkReply::Error::Connection4XX;
+                    break;
+                case AVERROR_HTTP_SERVER_ERROR:
+                    m_error = NetworkReply::Error::Connection5XX;
+                    continue; // Continue if server error (e.g. Service Temporarily Unavailable)
+                default:
+                    m_error = NetworkReply::Error::Connection;
+                    continue; // Continue if connection error
+            }
+            break;
+        } while (--m_retries > 0 && doSleep(m_aborted, m_retryInterval));
+
+        if (m_error == NetworkReply::Error::Ok)
+        {
+            char *cookies = nullptr;
+            if (av_opt_get(m_ctx, "cookies", AV_OPT_SEARCH_CHILDREN, (uint8_t **)&cookies) >= 0)
+            {
+                for (const QByteArray &cookie : QByteArray(cookies).trimmed().split('\n'))
                 {
-                    case AVERROR_HTTP_BAD_REQUEST:
-                        m_error = NetworkReply::Error::Connection400;
-                        break;
-                    case AVERROR_HTTP_UNAUTHORIZED:
-                        m_error = NetworkReply::Error::Connection401;
-                        break;
-                    case AVERROR_HTTP_FORBIDDEN:
-                        m_error = NetworkReply::Error::Connection403;
-                        break;
-                    case AVERROR_HTTP_NOT_FOUND:
-                        m_error = NetworkReply::Error::Connection404;
-                        break;
-                    case AVERROR_HTTP_OTHER_4XX:
-                        m_error = NetworkReply::Error::Connection4XX;
-                        break;
-                    case AVERROR_HTTP_SERVER_ERROR:
-                        m_error = NetworkReply::Error::Connection5XX;
-                        continue; // Continue if server error (e.g. Service Temporarily Unavailable)
-                    default:
-                        m_error = NetworkReply::Error::Connection;
-                        continue; // Continue if connection error
+                    int idx = cookie.indexOf(';');
+                    if (idx < 0)
+                        idx = cookie.length();
+                    if (idx > 0)
+                        m_cookies += cookie.left(idx) + "; ";
                 }
-                break;
-            } while (--m_retries > 0 && doSleep(m_aborted, m_retryInterval));
+                m_cookies.chop(1);
+                av_free(cookies);
+            }
 
-            if (m_error == NetworkReply::Error::Ok)
+            int64_t size = avio_size(m_ctx);
+            if (size >= m_maxSize)
+                m_error = NetworkReply::Error::FileTooLarge;
+            else
             {
-                char *cookies = nullptr;
-                if (av_opt_get(m_ctx, "cookies", AV_OPT_SEARCH_CHILDREN, (uint8_t **)&cookies) >= 0)
+                if (size < -1)
+                    size = -1; //Unknown size
+
+                if (size > 0)
                 {
-                    for (const QByteArray &cookie : QByteArray(cookies).trimmed().split('\n'))
-                    {
-                        int idx = cookie.indexOf(';');
-                        if (idx < 0)
-                            idx = cookie.length();
-                        if (idx > 0)
-                            m_cookies += cookie.left(idx) + "; ";
-                    }
-                    m_cookies.chop(1);
-                    av_free(cookies);
+                    // Append the chunks without reallocations
+                    m_dataMutex.lock();
+                    m_data.reserve(size);
+                    m_dataMutex.unlock();
                 }
 
-                int64_t size = avio_size(m_ctx);
-                if (size >= m_maxSize)
-                    m_error = NetworkReply::Error::FileTooLarge;
-                else
+                const int chunkSize = qMax<int>(4096, size / 1000);
+                quint8 *data = new quint8[chunkSize];
+                int64_t pos = 0;
+
+                for (;;)
                 {
-                    if (size < -1)
-                        size = -1; //Unknown size
+                    const int received = avio_read(m_ctx, data, chunkSize);
 
-                    const int chunkSize = qMax<int>(4096, size / 1000);
-                    quint8 *data = new quint8[chunkSize];
-                    int64_t pos = 0;
+                    if (received < 0) //Error
+                    {
+                        if (received != AVERROR_EOF)
+                            m_error = NetworkReply::Error::Download;
+                        break;
+                    }
 
-                    for (;;)
+                    if (received > 0)
                     {
-                        const int received = avio_read(m_ctx, data, chunkSize);
-
-                        if (received < 0) //Error
-                        {
-                            if (received != AVERROR_EOF)
-                                m_error = NetworkReply::Error::Download;
-                            break;
-                        }
-
-                        if (received > 0)
-                        {
-                            pos += received;
-
-                            m_dataMutex.lock();
-                            const int dataPos = m_data.size();
-                            m_data.resize(dataPos + received);
-                            memcpy(m_data.data() + dataPos, data, received);
-                            m_dataMutex.unlock();
-
-                            m_networkReplyMutex.lock();
-                            if (m_networkReply)
-                                emit m_networkReply->downloadProgress(pos, size);
-                            m_networkReplyMutex.unlock();
-                        }
-
-                        if (received < chunkSize) //EOF
-                            break;
-
-                        if (pos + chunkSize >= m_maxSize)
-                        {
-                            m_error = NetworkReply::Error::FileTooLarge;
-                            break;
-                        }
+                        pos += received;
+
+                        m_dataMutex.lock();
+                        const int dataPos = m_data.size();
+                        m_data.resize(dataPos + received);
+                        memcpy(m_data.data() + dataPos, data, received);
+                        m_dataMutex.unlock();
+
+                        if (cacheData)
+                            cacheData->append((const char *)data, received);
+
+                        m_networkReplyMutex.lock();
+                        if (m_networkReply)
+                            emit m_networkReply->downloadProgress(pos, size);
+                        m_networkReplyMutex.unlock();
                     }
 
-                    delete[] data;
+                    if (received < chunkSize) //EOF
+                        break;
+
+                    if (pos + chunkSize >= m_maxSize)
+                    {
+                        m_error = NetworkReply::Error::FileTooLarge;
+                        break;
+                    }
                 }
 
-                avio_closep(&m_ctx);
+                delete[] data;
             }
+
+            avio_closep(&m_ctx);
         }
 
-        m_networkReplyMutex.lock();
-        if (m_networkReply)
-            emit m_networkReply->finished();
-        m_networkReplyMutex.unlock();
+        NetworkSlots::instance().release(host);
     }
 };
 
@@ -255,6 +393,12 @@ void NetworkReply::abort()
     m_priv->m_aborted = true;
 }
 
+void NetworkReply::setPriority(int priority)
+{
+    m_priv->m_priority = priority;
+    NetworkSlots::instance().priorityChanged();
+}
+
 bool NetworkReply::hasError() const
 {
     return (error() != Error::Ok);
@@ -350,6 +494,11 @@ void NetworkAccess::setRetries(const int retries, const int retryInterval)
     }
 }
 
+void NetworkAccess::setPriority(const int priority)
+{
+    m_params->priority = priority;
+}
+
 int NetworkAccess::getRetries() const
 {
     return m_params->retries;
@@ -365,6 +514,13 @@ NetworkReply *NetworkAccess::start(const QString &url, const QByteArray &postDat
     reply->m_priv->start();
     return reply;
 }
+NetworkReply *NetworkAccess::startCached(const QString &url, const QByteArray &rawHeaders)
+{
+    m_params->cached = true;
+    NetworkReply *reply = start(url, QByteArray(), rawHeaders);
+    m_params->cached = false;
+    return reply;
+}
 bool NetworkAccess::start(IOController<NetworkReply> &ioCtrl, const QString &url, const QByteArray &postData, const QByteArray &rawHeaders)
 {
     return ioCtrl.assign(start(url, postData, rawHeaders));
@@ -65,6 +65,9 @@ public:
 
     void abort() override;
 
+    // Requests with higher priority are connected first when too many are pending
+    void setPriority(int priority);
+
     bool hasError() const;
     Error error() const;
 
@@ -102,12 +105,16 @@ public:
     void setCustomUserAgent(const QString &customUserAgent);
     void setMaxDownloadSize(const int maxSize);
     void setRetries(const int retries, const int retryInterval = s_defaultRetryInterval); // retryInterval is in 1/10 sec units
+    void setPriority(const int priority); // For new requests, see "NetworkReply::setPriority()"
 
     int getRetries() const;
 
     NetworkReply *start(const QString &url, const QByteArray &postData = QByteArray(), const QByteArray &rawHeaders = QByteArray());
     bool start(IOController<NetworkReply> &ioCtrl, const QString &url, const QByteArray &postData = QByteArray(), const QByteArray &rawHeaders = QByteArray());
 
+    // GET request for static resources (icons, thumbnails), served from a persistent cache if possible
+    NetworkReply *startCached(const QString &url, const QByteArray &rawHeaders = QByteArray());
+
     bool startAndWait(IOController<NetworkReply> &ioCtrl, const QString &url, const QByteArray &postData = QByteArray(), const QByteArray &rawHeaders = QByteArray(), const int retries = -1);
 
 signals:
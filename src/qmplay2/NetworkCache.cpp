@@ -0,0 +1,147 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <NetworkCache.hpp>
+
+#include <QMPlay2Core.hpp>
+#include <Functions.hpp>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+
+constexpr qint64 g_maxCacheSize = 64 * 1024 * 1024;
+constexpr qint64 g_maxEntryAge = 7 * 24 * 60 * 60; // 7 days in seconds
+constexpr quint32 g_cacheVersion = 1;
+
+NetworkCache::NetworkCache()
+    : m_dir(QMPlay2Core.getCacheDir() + "NetworkCache/")
+{
+    QDir().mkpath(m_dir);
+}
+
+NetworkCache &NetworkCache::instance()
+{
+    static NetworkCache networkCache;
+    return networkCache;
+}
+
+NetworkCache::Lookup NetworkCache::lookup(const QString &url, QByteArray &data, const bool &aborted)
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;)
+    {
+        while (!aborted && m_inFlight.contains(url))
+            m_cond.wait(&m_mutex, 100); // Timeout to check the "aborted" flag
+        if (aborted)
+            return Lookup::Aborted;
+
+        locker.unlock();
+        const bool hit = read(url, data);
+        locker.relock();
+
+        if (hit)
+        {
+            ++m_hits;
+            return Lookup::Hit;
+        }
+        if (!m_inFlight.contains(url))
+            break;
+    }
+    m_inFlight.insert(url);
+    ++m_misses;
+    return Lookup::Miss;
+}
+void NetworkCache::finishDownload(const QString &url, const QByteArray &data, bool ok)
+{
+    // Write before waking up the others, so they will find it
+    if (ok)
+        write(url, data);
+
+    QMutexLocker locker(&m_mutex);
+    m_inFlight.remove(url);
+    m_cond.wakeAll();
+}
+
+quint64 NetworkCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+quint64 NetworkCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+QString NetworkCache::filePath(const QString &url) const
+{
+    return m_dir + QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+bool NetworkCache::read(const QString &url, QByteArray &data)
+{
+    QFile f(filePath(url));
+    if (!f.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&f);
+    quint32 version = 0;
+    QString storedUrl;
+    qint64 storedTime = 0;
+    stream >> version >> storedUrl >> storedTime >> data;
+
+    const bool ok = (stream.status() == QDataStream::Ok && version == g_cacheVersion && storedUrl == url);
+    if (!ok || QDateTime::currentSecsSinceEpoch() - storedTime > g_maxEntryAge)
+    {
+        // Outdated, corrupted or a hash collision
+        data.clear();
+        return false;
+    }
+
+    // The modification time is the last access time for the eviction
+    f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+void NetworkCache::write(const QString &url, const QByteArray &data)
+{
+    if (data.isEmpty() || data.size() > g_maxCacheSize / 16)
+        return;
+
+    QSaveFile f(filePath(url));
+    if (!f.open(QFile::WriteOnly))
+        return;
+
+    QDataStream stream(&f);
+    stream << g_cacheVersion << url << QDateTime::currentSecsSinceEpoch() << data;
+    const qint64 size = f.size();
+    if (stream.status() != QDataStream::Ok || !f.commit())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_totalSize >= 0)
+        m_totalSize += size;
+    if (m_totalSize < 0 || m_totalSize > g_maxCacheSize)
+    {
+        // Remove the least recently used entries until there is a free space for new ones
+        m_totalSize = Functions::evictOldFiles(m_dir, g_maxCacheSize * 3 / 4);
+    }
+}
@@ -0,0 +1,67 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMPlay2Lib.hpp>
+
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QSet>
+
+/* Persistent cache for downloaded resources like icons and thumbnails */
+class QMPLAY2SHAREDLIB_EXPORT NetworkCache
+{
+    NetworkCache();
+    ~NetworkCache() = default;
+
+public:
+    enum class Lookup
+    {
+        Hit,
+        Miss,
+        Aborted
+    };
+
+    static NetworkCache &instance();
+
+    // Only one request downloads a given URL, the others wait for it and read the cache.
+    // On "Miss" the caller must download the data and call "finishDownload()".
+    Lookup lookup(const QString &url, QByteArray &data, const bool &aborted);
+    void finishDownload(const QString &url, const QByteArray &data, bool ok);
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    QString filePath(const QString &url) const;
+
+    bool read(const QString &url, QByteArray &data);
+    void write(const QString &url, const QByteArray &data);
+
+private:
+    const QString m_dir;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_cond;
+    QSet<QString> m_inFlight;
+    qint64 m_totalSize = -1;
+    quint64 m_hits = 0, m_misses = 0;
+};
@@ -66,6 +66,10 @@ void Packet::clear()
     av_packet_unref(m_packet);
 }
 
+AVRational Packet::timeBase() const
+{
+    return m_timeBase;
+}
 void Packet::setTimeBase(const AVRational &timeBase)
 {
     m_timeBase = timeBase;
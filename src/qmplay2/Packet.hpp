@@ -42,6 +42,7 @@ public:
     bool isEmpty() const;
     void clear();
 
+    AVRational timeBase() const;
     void setTimeBase(const AVRational &timeBase);
     void setOffsetTS(double offsetTS);
 
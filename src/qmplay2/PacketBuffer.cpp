@@ -18,11 +18,17 @@
 
 #include <PacketBuffer.hpp>
 
+#include <PacketSpill.hpp>
+
 #include <cmath>
 
 #include <QDebug>
 
 double PacketBuffer::s_backwardTime;
+qint64 PacketBuffer::s_spillSize;
+
+PacketBuffer::PacketBuffer() = default;
+PacketBuffer::~PacketBuffer() = default;
 
 void PacketBuffer::iterate(const IterateCallback &cb)
 {
@@ -30,42 +36,86 @@ void PacketBuffer::iterate(const IterateCallback &cb)
 
     const int count = packetsCount();
 
+    // Iterate packets starting when found keyframe
+    bool hasKeyframe = false;
+    auto iteratePacket = [&](const Packet &packet) {
+        if (!hasKeyframe && packet.hasKeyFrame())
+            hasKeyframe = true;
+        if (hasKeyframe)
+            return cb(packet);
+        return true;
+    };
+
     int startPos = m_pos;
-    if (startPos >= count)
+    if (isReplaying())
     {
-        unlock();
-        return;
+        // Start from on-disk packets, continue with all packets in memory
+        int spillStartPos = m_spillPos;
+        for (int i = spillStartPos; i >= 0; --i) // Find nearest keyframe (backwards)
+        {
+            if (m_spill->hasKeyFrame(i))
+            {
+                spillStartPos = i;
+                break;
+            }
+        }
+        for (int i = spillStartPos; i < m_spill->count(); ++i)
+        {
+            if (!iteratePacket(m_spill->read(i)))
+            {
+                unlock();
+                return;
+            }
+        }
     }
-
-    for (int i = startPos; i >= 0; --i) // Find nearest keyframe (backwards)
+    else
     {
-        auto &packet = atPos(i);
-        if (packet.hasKeyFrame())
+        if (startPos >= count)
         {
-            startPos = i;
-            break;
+            unlock();
+            return;
         }
-    }
 
-    // Iterate packets starting when found keyframe
-    bool hasKeyframe = false;
-    for (int i = startPos; i < count; ++i)
-    {
-        auto &packet = atPos(i);
-        if (!hasKeyframe && packet.hasKeyFrame())
-            hasKeyframe = true;
-        if (hasKeyframe)
+        for (int i = startPos; i >= 0; --i) // Find nearest keyframe (backwards)
         {
-            if (!cb(packet))
+            auto &packet = atPos(i);
+            if (packet.hasKeyFrame())
+            {
+                startPos = i;
                 break;
+            }
         }
     }
 
+    for (int i = startPos; i < count; ++i)
+    {
+        if (!iteratePacket(atPos(i)))
+            break;
+    }
+
     unlock();
 }
 
 bool PacketBuffer::seekTo(double seekPos, bool backward)
 {
+    if (isReplaying())
+    {
+        if (empty() || seekPos < atPos(0).ts())
+            return seekToSpill(seekPos, backward);
+
+        // Seek target is in memory, leave the on-disk packets
+        const int spillPos = m_spillPos;
+        const double remainingDuration = m_remainingDuration;
+        const qint64 remainingBytes = m_remainingBytes;
+        leaveSpill();
+        if (seekTo(seekPos, backward))
+            return true;
+        m_spillPos = spillPos;
+        m_remainingDuration = remainingDuration;
+        m_remainingBytes = remainingBytes;
+        return false;
+    }
+
     const int count = packetsCount();
     if (count == 0)
         return false;
@@ -74,6 +124,8 @@ bool PacketBuffer::seekTo(double seekPos, bool backward)
 
     if (findBackwards && atPos(0).ts() > seekPos)
     {
+        if (m_spill && !m_spill->isEmpty() && floor(m_spill->firstTime()) <= seekPos)
+            return seekToSpill(seekPos, backward);
         if (floor(atPos(0).ts()) > seekPos)
             return false; // No packets for backward seek
         seekPos = atPos(0).ts();
@@ -143,6 +195,8 @@ void PacketBuffer::clear()
 {
     lock();
     std::deque<Packet>::clear();
+    m_spill.reset();
+    m_spillPos = -1;
     m_remainingDuration = m_backwardDuration = 0.0;
     m_remainingBytes = m_backwardBytes = 0;
     m_pos = 0;
@@ -160,6 +214,16 @@ void PacketBuffer::put(const Packet &packet)
 }
 Packet PacketBuffer::fetch()
 {
+    if (isReplaying())
+    {
+        const Packet packet = m_spill->read(m_spillPos);
+        m_remainingDuration -= packet.duration();
+        m_remainingBytes -= packet.size();
+        if (++m_spillPos >= m_spill->count())
+            m_spillPos = -1; // Continue with packets in memory
+        return packet;
+    }
+
     const Packet &packet = atPos(m_pos++);
     m_remainingDuration -= packet.duration();
     m_backwardDuration += packet.duration();
@@ -173,6 +237,13 @@ void PacketBuffer::clearBackwards()
     while (m_backwardDuration > s_backwardTime && m_pos > 0)
     {
         const Packet &tmpPacket = *begin();
+        if (s_spillSize > 0)
+        {
+            if (!m_spill)
+                m_spill = std::make_unique<PacketSpill>(s_spillSize);
+            if (!m_spill->append(tmpPacket))
+                m_spill->clear(); // On-disk packets must be contiguous with packets in memory
+        }
         m_backwardDuration -= tmpPacket.duration();
         m_backwardBytes -= tmpPacket.size();
         erase(begin());
@@ -180,6 +251,76 @@ void PacketBuffer::clearBackwards()
     }
 }
 
+double PacketBuffer::firstPacketTime() const
+{
+    if (m_spill && !m_spill->isEmpty())
+        return m_spill->firstTime();
+    return begin()->ts();
+}
+double PacketBuffer::currentPacketTime() const
+{
+    if (isReplaying())
+        return m_spill->time(m_spillPos);
+    return at(m_pos).ts();
+}
+double PacketBuffer::lastPacketTime() const
+{
+    if (empty())
+        return m_spill->lastTime();
+    return (--end())->ts();
+}
+
+int PacketBuffer::remainingSpillCount() const
+{
+    return isReplaying() ? (m_spill->count() - m_spillPos) : 0;
+}
+
+bool PacketBuffer::seekToSpill(double seekPos, bool backward)
+{
+    if (!isReplaying())
+    {
+        // Move all backward packets to disk, so the on-disk packets are followed by the remaining packets only
+        for (; m_pos > 0; --m_pos)
+        {
+            const Packet &tmpPacket = *begin();
+            if (!m_spill->append(tmpPacket))
+                m_spill->clear();
+            erase(begin());
+        }
+        m_backwardDuration = 0.0;
+        m_backwardBytes = 0;
+        if (m_spill->isEmpty())
+            return false;
+    }
+
+    int pos = m_spill->findPos(seekPos, backward);
+    if (pos < 0)
+        pos = m_spill->findPos(seekPos, !backward);
+    if (pos < 0)
+        return false;
+
+    const int currPos = isReplaying() ? m_spillPos : m_spill->count();
+    if (pos < currPos)
+    {
+        m_remainingDuration += m_spill->duration(pos, currPos);
+        m_remainingBytes += m_spill->bytes(pos, currPos);
+    }
+    else
+    {
+        m_remainingDuration -= m_spill->duration(currPos, pos);
+        m_remainingBytes -= m_spill->bytes(currPos, pos);
+    }
+    m_spillPos = pos;
+
+    return true;
+}
+void PacketBuffer::leaveSpill()
+{
+    m_remainingDuration -= m_spill->duration(m_spillPos, m_spill->count());
+    m_remainingBytes -= m_spill->bytes(m_spillPos, m_spill->count());
+    m_spillPos = -1;
+}
+
 inline Packet &PacketBuffer::atPos(size_type idx)
 {
     return operator[](idx);
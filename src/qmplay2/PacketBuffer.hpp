@@ -23,19 +23,30 @@
 #include <QMutex>
 
 #include <functional>
+#include <memory>
 #include <deque>
 
+class PacketSpill;
+
 class QMPLAY2SHAREDLIB_EXPORT PacketBuffer : private std::deque<Packet>
 {
     using IterateCallback = std::function<bool(const Packet &)>;
 
     static double s_backwardTime;
+    static qint64 s_spillSize;
 
 public:
     static void setBackwardTime(double time)
     {
         s_backwardTime = time;
     }
+    static void setSpillSize(qint64 size) // Size of on-disk timeshift in bytes, 0 disables
+    {
+        s_spillSize = size;
+    }
+
+    PacketBuffer();
+    ~PacketBuffer();
 
     void iterate(const IterateCallback &cb);
 
@@ -49,7 +60,7 @@ public:
 
     inline bool isEmpty() const
     {
-        return empty();
+        return empty() && !isReplaying();
     }
 
     inline bool canFetch() const
@@ -58,25 +69,16 @@ public:
     }
     inline int remainingPacketsCount() const
     {
-        return packetsCount() - m_pos;
+        return packetsCount() - m_pos + remainingSpillCount();
     }
     inline int packetsCount() const
     {
         return size();
     }
 
-    inline double firstPacketTime() const
-    {
-        return begin()->ts();
-    }
-    inline double currentPacketTime() const
-    {
-        return at(m_pos).ts();
-    }
-    inline double lastPacketTime() const
-    {
-        return (--end())->ts();
-    }
+    double firstPacketTime() const;
+    double currentPacketTime() const;
+    double lastPacketTime() const;
 
     inline double remainingDuration() const
     {
@@ -100,6 +102,14 @@ public:
     {
         m_mutex.lock();
     }
+    inline bool tryLock()
+    {
+        return m_mutex.tryLock();
+    }
+    inline bool tryLock(int timeout)
+    {
+        return m_mutex.tryLock(timeout);
+    }
     inline void unlock()
     {
         m_mutex.unlock();
@@ -108,7 +118,18 @@ public:
 private:
     inline Packet &atPos(size_type idx);
 
+    inline bool isReplaying() const
+    {
+        return (m_spillPos > -1);
+    }
+    int remainingSpillCount() const;
+
+    bool seekToSpill(double seekPos, bool backward);
+    void leaveSpill();
+
 private:
+    std::unique_ptr<PacketSpill> m_spill;
+    int m_spillPos = -1; // Position in on-disk packets, "-1" if fetching from memory
     double m_remainingDuration = 0.0, m_backwardDuration = 0.0;
     qint64 m_remainingBytes = 0, m_backwardBytes = 0;
     QMutex m_mutex;
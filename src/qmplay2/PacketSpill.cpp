@@ -0,0 +1,224 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <PacketSpill.hpp>
+
+#include <QMPlay2Core.hpp>
+
+#include <QTemporaryFile>
+#include <QDebug>
+#include <QDir>
+
+#include <algorithm>
+#include <cstring>
+
+constexpr qint64 g_minSegmentSize = 1 << 20;
+constexpr qint64 g_maxSegmentSize = 64 << 20;
+
+struct SideDataHeader
+{
+    qint32 type;
+    qint32 size;
+};
+
+PacketSpill::PacketSpill(qint64 maxSize)
+    : m_maxSize(maxSize)
+{}
+PacketSpill::~PacketSpill()
+{
+    clear();
+}
+
+bool PacketSpill::append(const Packet &packet)
+{
+    const int size = packet.size();
+    if (size <= 0)
+        return true;
+
+    const AVPacket *avPacket = packet;
+
+    // Side data is stored after the packet data
+    int sideDataSize = 0;
+    for (int i = 0; i < avPacket->side_data_elems; ++i)
+        sideDataSize += sizeof(SideDataHeader) + avPacket->side_data[i].size;
+
+    const int totalSize = size + sideDataSize;
+    if (m_segments.empty() || m_segments.back().size - m_segments.back().used < totalSize)
+    {
+        if (!addSegment(totalSize))
+            return false;
+    }
+
+    auto &segment = m_segments.back();
+
+    Entry entry;
+    entry.segment = m_firstSegment + m_segments.size() - 1;
+    entry.offset = segment.used;
+    entry.pts = avPacket->pts;
+    entry.dts = avPacket->dts;
+    entry.duration = avPacket->duration;
+    entry.timeBase = packet.timeBase();
+    entry.ts = packet.ts();
+    entry.durationSec = packet.duration();
+    entry.size = size;
+    entry.sideDataSize = sideDataSize;
+    entry.sideDataElems = avPacket->side_data_elems;
+    entry.flags = avPacket->flags;
+
+    uchar *data = segment.data + segment.used;
+    memcpy(data, packet.data(), size);
+    data += size;
+    for (int i = 0; i < avPacket->side_data_elems; ++i)
+    {
+        const auto &sideData = avPacket->side_data[i];
+        const SideDataHeader header {
+            static_cast<qint32>(sideData.type),
+            static_cast<qint32>(sideData.size),
+        };
+        memcpy(data, &header, sizeof(header));
+        data += sizeof(header);
+        memcpy(data, sideData.data, sideData.size);
+        data += sideData.size;
+    }
+    segment.used += totalSize;
+
+    m_entries.push_back(entry);
+
+    return true;
+}
+Packet PacketSpill::read(int idx) const
+{
+    const Entry &entry = m_entries[idx];
+    const Segment &segment = m_segments[entry.segment - m_firstSegment];
+
+    AVPacket *avPacket = av_packet_alloc();
+    if (av_new_packet(avPacket, entry.size) == 0)
+    {
+        const uchar *data = segment.data + entry.offset;
+        memcpy(avPacket->data, data, entry.size);
+        data += entry.size;
+        for (int i = 0; i < entry.sideDataElems; ++i)
+        {
+            SideDataHeader header;
+            memcpy(&header, data, sizeof(header));
+            data += sizeof(header);
+            if (auto sideData = av_packet_new_side_data(avPacket, static_cast<AVPacketSideDataType>(header.type), header.size))
+                memcpy(sideData, data, header.size);
+            data += header.size;
+        }
+        avPacket->pts = entry.pts;
+        avPacket->dts = entry.dts;
+        avPacket->duration = entry.duration;
+        avPacket->flags = entry.flags;
+    }
+
+    Packet packet(avPacket);
+    packet.setTimeBase(entry.timeBase);
+
+    av_packet_free(&avPacket);
+
+    return packet;
+}
+
+int PacketSpill::findPos(double ts, bool backward) const
+{
+    const auto it = std::upper_bound(m_entries.begin(), m_entries.end(), ts, [](double ts, const Entry &entry) {
+        return ts < entry.ts;
+    });
+
+    int idx = it - m_entries.begin();
+    if (backward)
+    {
+        for (--idx; idx >= 0; --idx)
+        {
+            if (m_entries[idx].flags & AV_PKT_FLAG_KEY)
+                return idx;
+        }
+    }
+    else
+    {
+        if (idx > 0 && m_entries[idx - 1].ts == ts)
+            --idx;
+        for (; idx < count(); ++idx)
+        {
+            if (m_entries[idx].flags & AV_PKT_FLAG_KEY)
+                return idx;
+        }
+    }
+
+    return -1;
+}
+
+double PacketSpill::duration(int from, int to) const
+{
+    double duration = 0.0;
+    for (int i = from; i < to; ++i)
+        duration += m_entries[i].durationSec;
+    return duration;
+}
+qint64 PacketSpill::bytes(int from, int to) const
+{
+    qint64 bytes = 0;
+    for (int i = from; i < to; ++i)
+        bytes += m_entries[i].size;
+    return bytes;
+}
+
+void PacketSpill::clear()
+{
+    m_entries.clear();
+    while (!m_segments.empty())
+        dropFirstSegment();
+    m_firstSegment = 0;
+}
+
+bool PacketSpill::addSegment(qint64 minSize)
+{
+    const qint64 size = qMax<qint64>(minSize, qBound(g_minSegmentSize, m_maxSize / 8, g_maxSegmentSize));
+
+    while (!m_segments.empty() && m_totalSize + size > m_maxSize)
+        dropFirstSegment();
+
+    // Don't use the temporary directory, it is often in RAM (tmpfs)
+    const QString dir = QMPlay2Core.getCacheDir();
+    QDir().mkpath(dir);
+
+    Segment segment;
+    segment.file = std::make_unique<QTemporaryFile>(dir + "QMPlay2.timeshift.XXXXXX");
+    if (!segment.file->open() || !segment.file->resize(size) || !(segment.data = segment.file->map(0, size)))
+    {
+        qWarning() << "Unable to create timeshift segment:" << segment.file->errorString();
+        return false;
+    }
+    segment.size = size;
+
+    m_totalSize += size;
+    m_segments.push_back(std::move(segment));
+
+    return true;
+}
+void PacketSpill::dropFirstSegment()
+{
+    auto &segment = m_segments.front();
+    while (!m_entries.empty() && m_entries.front().segment == m_firstSegment)
+        m_entries.pop_front();
+    segment.file->unmap(segment.data);
+    m_totalSize -= segment.size;
+    m_segments.pop_front();
+    ++m_firstSegment;
+}
@@ -0,0 +1,112 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Packet.hpp>
+
+#include <memory>
+#include <deque>
+
+class QTemporaryFile;
+
+/*
+ * On-disk, append-only packet log used as a timeshift tier for "PacketBuffer".
+ * Packets (with their side data) are stored in memory-mapped temporary segment
+ * files in the cache directory, the oldest segment is dropped when the log
+ * exceeds its maximum size.
+ */
+class PacketSpill
+{
+    Q_DISABLE_COPY(PacketSpill)
+
+    struct Segment
+    {
+        std::unique_ptr<QTemporaryFile> file;
+        uchar *data = nullptr;
+        qint64 size = 0;
+        qint64 used = 0;
+    };
+
+    struct Entry
+    {
+        quint64 segment;
+        qint64 offset;
+        qint64 pts, dts, duration;
+        AVRational timeBase;
+        double ts;
+        double durationSec;
+        int size;
+        int sideDataSize;
+        int sideDataElems;
+        int flags;
+    };
+
+public:
+    PacketSpill(qint64 maxSize);
+    ~PacketSpill();
+
+    inline bool isEmpty() const
+    {
+        return m_entries.empty();
+    }
+    inline int count() const
+    {
+        return m_entries.size();
+    }
+
+    inline double firstTime() const
+    {
+        return m_entries.front().ts;
+    }
+    inline double lastTime() const
+    {
+        return m_entries.back().ts;
+    }
+    inline double time(int idx) const
+    {
+        return m_entries[idx].ts;
+    }
+    inline bool hasKeyFrame(int idx) const
+    {
+        return (m_entries[idx].flags & AV_PKT_FLAG_KEY);
+    }
+
+    bool append(const Packet &packet);
+    Packet read(int idx) const;
+
+    int findPos(double ts, bool backward) const;
+
+    double duration(int from, int to) const;
+    qint64 bytes(int from, int to) const;
+
+    void clear();
+
+private:
+    bool addSegment(qint64 minSize);
+    void dropFirstSegment();
+
+private:
+    const qint64 m_maxSize;
+
+    std::deque<Segment> m_segments;
+    quint64 m_firstSegment = 0;
+    qint64 m_totalSize = 0;
+
+    std::deque<Entry> m_entries;
+};
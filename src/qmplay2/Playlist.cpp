@@ -18,6 +18,7 @@
 
 #include <Playlist.hpp>
 
+#include <PlaylistSession.hpp>
 #include <Functions.hpp>
 #include <Module.hpp>
 #include <Writer.hpp>
@@ -25,6 +26,15 @@
 
 Playlist::Entries Playlist::read(const QString &url, QString *name)
 {
+    if (PlaylistSession::isSessionUrl(url))
+    {
+        bool ok = false;
+        Entries list = PlaylistSession::read(url.mid(7), &ok);
+        if (ok && name)
+            *name = "QMPlay2 session";
+        return list;
+    }
+
     Entries list;
     Playlist *playlist = create(url, ReadOnly, name);
     if (playlist)
@@ -0,0 +1,206 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <PlaylistSession.hpp>
+
+#include <QSaveFile>
+#include <QtEndian>
+#include <QFile>
+
+#include <cstring>
+
+constexpr char g_magic[8] = {'Q', 'M', 'P', 'L', 'I', 'S', 'T', '\0'};
+constexpr quint32 g_version = 1;
+
+namespace {
+
+#pragma pack(push, 1)
+struct Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 entriesCount;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+};
+struct Record
+{
+    quint32 nameOffset, nameSize;
+    quint32 urlOffset, urlSize;
+    quint32 paramsOffset, paramsSize;
+    quint64 length; // IEEE 754 double
+    qint32 flags, queue, GID, parent;
+};
+#pragma pack(pop)
+
+class StringTable
+{
+public:
+    inline void append(const QByteArray &str, quint32 &offset, quint32 &size)
+    {
+        offset = qToLittleEndian<quint32>(m_data.size());
+        size = qToLittleEndian<quint32>(str.size());
+        m_data.append(str);
+    }
+
+    inline const QByteArray &data() const
+    {
+        return m_data;
+    }
+
+private:
+    QByteArray m_data;
+};
+
+}
+
+bool PlaylistSession::isSessionUrl(const QString &url)
+{
+    return url.startsWith("file://") && url.endsWith(QLatin1Char('.') + QLatin1String(Extension), Qt::CaseInsensitive);
+}
+
+PlaylistEntries PlaylistSession::read(const QString &filePath, bool *ok)
+{
+    PlaylistEntries entries;
+    if (ok)
+        *ok = false;
+
+    QFile f(filePath);
+    if (!f.open(QFile::ReadOnly) || f.size() < static_cast<qint64>(sizeof(Header)))
+        return entries;
+
+    const quint64 fileSize = f.size();
+    const uchar *data = f.map(0, fileSize);
+    if (!data)
+        return entries;
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    const quint32 entriesCount = qFromLittleEndian(header.entriesCount);
+    const quint64 stringsOffset = qFromLittleEndian(header.stringsOffset);
+    const quint64 stringsSize = qFromLittleEndian(header.stringsSize);
+    if (memcmp(header.magic, g_magic, sizeof(g_magic)) != 0 || qFromLittleEndian(header.version) != g_version)
+        return entries;
+    if (sizeof(Header) + static_cast<quint64>(entriesCount) * sizeof(Record) > stringsOffset || stringsOffset + stringsSize > fileSize)
+        return entries;
+
+    const char *strings = reinterpret_cast<const char *>(data + stringsOffset);
+    const auto getString = [&](quint32 offset, quint32 size, const char *&str) {
+        offset = qFromLittleEndian(offset);
+        size = qFromLittleEndian(size);
+        if (static_cast<quint64>(offset) + size > stringsSize)
+            return -1;
+        str = strings + offset;
+        return static_cast<int>(size);
+    };
+
+    entries.resize(entriesCount);
+    const uchar *recordData = data + sizeof(Header);
+    for (quint32 i = 0; i < entriesCount; ++i, recordData += sizeof(Record))
+    {
+        Record record;
+        memcpy(&record, recordData, sizeof(Record));
+
+        PlaylistEntry &entry = entries[i];
+
+        const char *str = nullptr;
+        int size = getString(record.nameOffset, record.nameSize, str);
+        if (size < 0)
+            return {};
+        entry.name = QString::fromUtf8(str, size);
+
+        size = getString(record.urlOffset, record.urlSize, str);
+        if (size < 0)
+            return {};
+        entry.url = QString::fromUtf8(str, size);
+
+        size = getString(record.paramsOffset, record.paramsSize, str);
+        if (size < 0)
+            return {};
+        for (const char *end = str + size; str < end;)
+        {
+            const QByteArray key(str, qstrnlen(str, end - str));
+            str += key.size() + 1;
+            if (str >= end)
+                break;
+            const QByteArray value(str, qstrnlen(str, end - str));
+            str += value.size() + 1;
+            entry.params[key] = value;
+        }
+
+        const quint64 length = qFromLittleEndian(record.length);
+        memcpy(&entry.length, &length, sizeof(double));
+        entry.flags = qFromLittleEndian(record.flags);
+        entry.queue = qFromLittleEndian(record.queue);
+        entry.GID = qFromLittleEndian(record.GID);
+        entry.parent = qFromLittleEndian(record.parent);
+    }
+
+    if (ok)
+        *ok = true;
+    return entries;
+}
+bool PlaylistSession::write(const PlaylistEntries &entries, const QString &filePath)
+{
+    QByteArray records(entries.size() * sizeof(Record), Qt::Uninitialized);
+    StringTable strings;
+
+    Record *record = reinterpret_cast<Record *>(records.data());
+    for (const PlaylistEntry &entry : entries)
+    {
+        QByteArray params;
+        for (auto it = entry.params.cbegin(), itEnd = entry.params.cend(); it != itEnd; ++it)
+        {
+            params.append(it.key());
+            params.append('\0');
+            params.append(it.value());
+            params.append('\0');
+        }
+
+        Record r;
+        strings.append(entry.name.toUtf8(), r.nameOffset, r.nameSize);
+        strings.append(entry.url.toUtf8(), r.urlOffset, r.urlSize);
+        strings.append(params, r.paramsOffset, r.paramsSize);
+
+        quint64 length;
+        memcpy(&length, &entry.length, sizeof(double));
+        r.length = qToLittleEndian(length);
+        r.flags = qToLittleEndian(entry.flags);
+        r.queue = qToLittleEndian(entry.queue);
+        r.GID = qToLittleEndian(entry.GID);
+        r.parent = qToLittleEndian(entry.parent);
+
+        memcpy(record++, &r, sizeof(Record));
+    }
+
+    Header header;
+    memcpy(header.magic, g_magic, sizeof(g_magic));
+    header.version = qToLittleEndian(g_version);
+    header.entriesCount = qToLittleEndian<quint32>(entries.size());
+    header.stringsOffset = qToLittleEndian<quint64>(sizeof(Header) + records.size());
+    header.stringsSize = qToLittleEndian<quint64>(strings.data().size());
+
+    // Written to a temporary file and renamed on commit, so the previous session survives a crash
+    QSaveFile f(filePath);
+    if (!f.open(QFile::WriteOnly))
+        return false;
+    f.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    f.write(records);
+    f.write(strings.data());
+    return f.commit();
+}
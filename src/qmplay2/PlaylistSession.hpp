@@ -0,0 +1,40 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <PlaylistEntry.hpp>
+#include <QMPlay2Lib.hpp>
+
+#include <QString>
+
+/*
+ * Binary session playlist which is stored on exit and loaded at startup.
+ * Fixed size entry records are followed by a single UTF-8 string table,
+ * so the whole file can be memory-mapped and read in one pass.
+ */
+class QMPLAY2SHAREDLIB_EXPORT PlaylistSession
+{
+public:
+    static constexpr auto Extension = "qmplist";
+
+    static bool isSessionUrl(const QString &url);
+
+    static PlaylistEntries read(const QString &filePath, bool *ok = nullptr);
+    static bool write(const PlaylistEntries &entries, const QString &filePath);
+};
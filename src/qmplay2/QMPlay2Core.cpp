@@ -263,6 +263,11 @@ void QMPlay2CoreClass::init(bool loadModulesAndGpu, bool modulesInSubdirs, const
     }
     QDir(settingsDir).mkpath(".");
 
+    if (Version::isPortable())
+        cacheDir = settingsDir + "Cache/";
+    else
+        cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/QMPlay2/";
+
     {
         settingsProfile = Functions::cleanFileName(profileName, QString());
         if (settingsProfile.isEmpty())
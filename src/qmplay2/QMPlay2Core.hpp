@@ -97,6 +97,10 @@ public:
     {
         return settingsDir;
     }
+    inline QString getCacheDir() const // Disk-backed, can be removed at any time
+    {
+        return cacheDir;
+    }
     inline QString getSettingsProfile() const
     {
         return settingsProfile;
@@ -258,7 +262,7 @@ private:
 
     QVector<Module *> pluginsInstance;
     QTranslator *translator, *qtTranslator;
-    QString shareDir, langDir, settingsDir, logFilePath, settingsProfile;
+    QString shareDir, langDir, settingsDir, cacheDir, logFilePath, settingsProfile;
     QAtomicInt working;
     QStringList logs;
     QMap<QString, QString> languages;
@@ -21,6 +21,7 @@
 #include <QStyleOptionSlider>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QLabel>
 #include <QStyle>
 
 Slider::Slider() :
@@ -58,6 +59,25 @@ void Slider::drawRange(int first, int second)
     }
 }
 
+void Slider::setPreview(const QImage &img)
+{
+    if (img.isNull() || !underMouse())
+    {
+        if (preview)
+            preview->hide();
+        return;
+    }
+    if (!preview)
+    {
+        preview = new QLabel(this, Qt::ToolTip);
+        preview->setFrameShape(QFrame::Box);
+    }
+    preview->setPixmap(QPixmap::fromImage(img));
+    preview->adjustSize();
+    preview->move(mapToGlobal(QPoint(lastMouseX - preview->width() / 2, -preview->height() - 2)));
+    preview->show();
+}
+
 void Slider::paintEvent(QPaintEvent *e)
 {
     QSlider::paintEvent(e);
@@ -137,6 +157,7 @@ void Slider::mouseMoveEvent(QMouseEvent *e)
     if (maximum() > 0)
     {
         int pos = getMousePos(e->pos());
+        lastMouseX = e->pos().x();
         if (pos != lastMousePos)
         {
             lastMousePos = pos;
@@ -163,6 +184,12 @@ void Slider::enterEvent(Q_ENTER_EVENT *e)
     lastMousePos = -1;
     QSlider::enterEvent(e);
 }
+void Slider::leaveEvent(QEvent *e)
+{
+    if (preview)
+        preview->hide();
+    QSlider::leaveEvent(e);
+}
 
 int Slider::getMousePos(const QPoint &pos)
 {
@@ -21,6 +21,9 @@
 #include <QMPlay2Lib.hpp>
 
 #include <QSlider>
+#include <QImage>
+
+class QLabel;
 
 class QMPLAY2SHAREDLIB_EXPORT Slider final : public QSlider
 {
@@ -44,6 +47,7 @@ public slots:
         wheelStep = ws;
     }
     void drawRange(int first, int second);
+    void setPreview(const QImage &img);
 protected:
     void paintEvent(QPaintEvent *) override;
     void mousePressEvent(QMouseEvent *) override;
@@ -51,12 +55,15 @@ protected:
     void mouseMoveEvent(QMouseEvent *) override;
     void wheelEvent(QWheelEvent *) override;
     void enterEvent(Q_ENTER_EVENT *) override;
+    void leaveEvent(QEvent *) override;
 private:
     int getMousePos(const QPoint &pos);
 
     bool canSetValue, ignoreValueChanged;
     int lastMousePos, wheelStep, firstLine, secondLine;
     int cachedSliderValue;
+    int lastMouseX = 0;
+    QLabel *preview = nullptr;
 signals:
     void mousePosition(int xPos);
 };
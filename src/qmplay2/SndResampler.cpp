@@ -17,6 +17,7 @@
 */
 
 #include <SndResampler.hpp>
+#include <TimeStretcher.hpp>
 
 #include <QVarLengthArray>
 #include <QByteArray>
@@ -47,11 +48,8 @@ using namespace RubberBand;
 
 bool SndResampler::canKeepPitch()
 {
-#ifdef QMPLAY2_RUBBERBAND
+    // Built-in WSOLA time-stretcher is always available
     return true;
-#else
-    return false;
-#endif
 }
 
 SndResampler::SndResampler()
@@ -69,19 +67,9 @@ const char *SndResampler::name() const
 
 bool SndResampler::create(int srcSamplerate, int srcChannels, int dstSamplerate, int dstChannels, double speed, bool keepPitch)
 {
-    m_keepPitch = keepPitch;
-
-#ifdef QMPLAY2_RUBBERBAND
-    if (m_keepPitch && qFuzzyCompare(speed, 1.0))
-#endif
-    {
-        m_keepPitch = false;
-    }
+    m_keepPitch = keepPitch && !qFuzzyCompare(speed, 1.0);
 
-#ifdef QMPLAY2_RUBBERBAND
-    if (!m_keepPitch || m_dstSamplerate != dstSamplerate || m_dstChannels != dstChannels)
-        m_rubberBandStretcher.reset();
-#endif
+    const bool formatChanged = (m_dstSamplerate != dstSamplerate || m_dstChannels != dstChannels);
 
     m_srcSamplerate = srcSamplerate;
     m_srcChannels  = srcChannels;
@@ -89,6 +77,16 @@ bool SndResampler::create(int srcSamplerate, int srcChannels, int dstSamplerate,
     m_dstChannels = dstChannels;
     m_speed = speed;
 
+    if (!m_keepPitch || formatChanged || !useRubberBand())
+        m_rubberBandStretcher.reset();
+    if (!m_keepPitch || formatChanged || useRubberBand())
+        m_timeStretcher.reset();
+
+    if (m_keepPitch && !useRubberBand() && !m_timeStretcher && m_dstSamplerate > 0 && m_dstChannels > 0)
+        m_timeStretcher = make_unique<TimeStretcher>(m_dstSamplerate, m_dstChannels);
+    if (m_timeStretcher)
+        m_timeStretcher->setSpeed(m_speed);
+
     if (!m_keepPitch)
     {
         m_dstSamplerate /= speed;
@@ -171,28 +169,31 @@ void SndResampler::convert(const QByteArray &src, QByteArray &dst, bool flush)
     const int inSize = src.size() / m_srcChannels / sizeof(float);
     const int possibleSwrSize = ceil(inSize * (double)m_dstSamplerate / (double)m_srcSamplerate);
 
-#ifndef QMPLAY2_RUBBERBAND
-    Q_UNUSED(flush)
-#else
-    if (m_keepPitch)
+    const quint8 *in[] = {(const quint8 *)src.constData()};
+
+    if (m_timeStretcher)
     {
-        QVarLengthArray<QByteArray, 8> tmpQ(m_dstChannels);
-        QVarLengthArray<quint8 *, 8> tmp(m_dstChannels);
+        if (inSize > 0)
+        {
+            // Convert directly into the stretcher input buffers
+            auto out = reinterpret_cast<quint8 **>(m_timeStretcher->inputBuffers(possibleSwrSize));
+            const int converted = swr_convert(m_sndConvertCtx, out, possibleSwrSize, in, inSize);
+            if (converted > 0)
+                m_timeStretcher->commit(converted);
+        }
+        m_timeStretcher->process(dst, flush);
+        return;
+    }
 
+#ifdef QMPLAY2_RUBBERBAND
+    if (m_keepPitch)
+    {
         if (!m_rubberBandStretcher)
         {
-            RubberBandStretcher::Options options = RubberBandStretcher::OptionProcessRealTime | RubberBandStretcher::OptionChannelsTogether;
-            if (QStringLiteral(RUBBERBAND_VERSION) != QStringLiteral("3.0.0") || m_dstSamplerate >= 40000)
-            {
-                // Workaround for RubberBand 3.0.0 bug:
-                // - low sample rates - bad audio quality
-                // - very low sample rates - crash
-                options |= RubberBandStretcher::OptionEngineFiner;
-            }
             m_rubberBandStretcher = make_unique<RubberBandStretcher>(
                 m_dstSamplerate,
                 m_dstChannels,
-                options
+                RubberBandStretcher::OptionProcessRealTime | RubberBandStretcher::OptionChannelsTogether | RubberBandStretcher::OptionEngineFiner
             );
         }
 
@@ -202,28 +203,23 @@ void SndResampler::convert(const QByteArray &src, QByteArray &dst, bool flush)
 
         if (!flush)
         {
-            const quint8 *in[] = {(const quint8 *)src.constData()};
+            quint8 **tmp = planarBuffers(possibleSwrSize);
 
-            for (int i = 0; i < m_dstChannels; ++i)
-            {
-                tmpQ[i] = QByteArray(possibleSwrSize * sizeof(float), Qt::Uninitialized);
-                tmp[i] = reinterpret_cast<quint8 *>(tmpQ[i].data());
-            }
-
-            const int converted = swr_convert(m_sndConvertCtx, tmp.data(), possibleSwrSize, in, inSize);
+            const int converted = swr_convert(m_sndConvertCtx, tmp, possibleSwrSize, in, inSize);
             if (converted <= 0)
             {
                 dst.clear();
                 return;
             }
 
-            m_rubberBandStretcher->process(reinterpret_cast<const float *const *>(tmp.constData()), converted, false);
+            m_rubberBandStretcher->process(reinterpret_cast<const float *const *>(tmp), converted, false);
         }
         else
         {
+            QVarLengthArray<float *, 8> tmp(m_dstChannels);
             for (int i = 0; i < m_dstChannels; ++i)
                 tmp[i] = nullptr;
-            m_rubberBandStretcher->process(reinterpret_cast<const float *const *>(tmp.constData()), 0, true);
+            m_rubberBandStretcher->process(tmp.constData(), 0, true);
         }
 
         const int available = m_rubberBandStretcher->available();
@@ -233,23 +229,18 @@ void SndResampler::convert(const QByteArray &src, QByteArray &dst, bool flush)
             return;
         }
 
-        for (int i = 0; i < m_dstChannels; ++i)
-        {
-            const int newSize = available * sizeof(float);
-            if (tmpQ[i].size() < newSize)
-                tmpQ[i] = QByteArray(available * sizeof(float), Qt::Uninitialized);
-            tmp[i] = reinterpret_cast<quint8 *>(tmpQ[i].data());
-        }
+        quint8 **tmp = planarBuffers(available);
 
-        m_rubberBandStretcher->retrieve(reinterpret_cast<float *const *>(tmp.constData()), available);
+        m_rubberBandStretcher->retrieve(reinterpret_cast<float *const *>(tmp), available);
 
-        dst = QByteArray(available * sizeof(float) * m_dstChannels, Qt::Uninitialized);
+        dst.resize(available * sizeof(float) * m_dstChannels);
         auto dstF = reinterpret_cast<float *>(dst.data());
         for (int c = 0; c < m_dstChannels; ++c)
         {
+            auto tmpF = reinterpret_cast<const float *>(tmp[c]);
             for (int i = 0; i < available; ++i)
             {
-                dstF[i * m_dstChannels + c] = reinterpret_cast<const float *>(tmp[c])[i];
+                dstF[i * m_dstChannels + c] = tmpF[i];
             }
         }
 
@@ -259,9 +250,10 @@ void SndResampler::convert(const QByteArray &src, QByteArray &dst, bool flush)
     else
 #endif
     {
+        Q_UNUSED(flush)
+
         dst.reserve(possibleSwrSize * sizeof(float) * m_dstChannels);
 
-        const quint8 *in[] = {(const quint8 *)src.constData()};
         quint8 *out[] = {(quint8 *)dst.data()};
 
         const int converted = swr_convert(m_sndConvertCtx, out, possibleSwrSize, in, inSize);
@@ -278,6 +270,8 @@ void SndResampler::cleanBuffers()
     if (m_rubberBandStretcher)
         m_rubberBandStretcher->reset();
 #endif
+    if (m_timeStretcher)
+        m_timeStretcher->reset();
 }
 void SndResampler::destroy()
 {
@@ -285,10 +279,13 @@ void SndResampler::destroy()
 #ifdef QMPLAY2_RUBBERBAND
     m_rubberBandStretcher.reset();
 #endif
+    m_timeStretcher.reset();
 }
 
 double SndResampler::getDelay() const
 {
+    if (m_timeStretcher)
+        return m_timeStretcher->getDelay();
 #ifdef QMPLAY2_RUBBERBAND
     return m_rubberBandStretcher
         ? static_cast<double>(m_rubberBandStretcher->getStartDelay()) / static_cast<double>(m_dstSamplerate)
@@ -300,6 +297,8 @@ double SndResampler::getDelay() const
 }
 bool SndResampler::hasBufferedSamples() const
 {
+    if (m_timeStretcher)
+        return m_timeStretcher->hasBufferedSamples();
 #ifdef QMPLAY2_RUBBERBAND
     return m_rubberBandStretcher
         ? m_rubberBandStretcher->getSamplesRequired() > 0
@@ -309,3 +308,28 @@ bool SndResampler::hasBufferedSamples() const
     return false;
 #endif
 }
+
+bool SndResampler::useRubberBand() const
+{
+#ifdef QMPLAY2_RUBBERBAND
+    // RubberBand 3.0.0 has bad audio quality at low sample rates and crashes at
+    // very low sample rates, use the built-in time-stretcher there instead.
+    return (QStringLiteral(RUBBERBAND_VERSION) != QStringLiteral("3.0.0") || m_dstSamplerate >= 40000);
+#else
+    return false;
+#endif
+}
+
+quint8 **SndResampler::planarBuffers(int count)
+{
+    m_planar.resize(m_dstChannels);
+    m_planarPtrs.resize(m_dstChannels);
+    for (int c = 0; c < m_dstChannels; ++c)
+    {
+        auto &planar = m_planar[c];
+        if (planar.size() < static_cast<size_t>(count))
+            planar.resize(count);
+        m_planarPtrs[c] = reinterpret_cast<quint8 *>(planar.data());
+    }
+    return m_planarPtrs.data();
+}
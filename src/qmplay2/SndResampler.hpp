@@ -21,7 +21,9 @@
 #include <QMPlay2Lib.hpp>
 
 #include <memory>
+#include <vector>
 
+class TimeStretcher;
 class QByteArray;
 struct SwrContext;
 
@@ -55,9 +57,17 @@ public:
     double getDelay() const;
     bool hasBufferedSamples() const;
 
+private:
+    bool useRubberBand() const;
+
+    quint8 **planarBuffers(int count);
+
 private:
     SwrContext *m_sndConvertCtx = nullptr;
     std::unique_ptr<RubberBand::RubberBandStretcher> m_rubberBandStretcher;
+    std::unique_ptr<TimeStretcher> m_timeStretcher;
+    std::vector<std::vector<float>> m_planar;
+    std::vector<quint8 *> m_planarPtrs;
     bool m_keepPitch = false;
     int m_srcSamplerate = 0;
     int m_srcChannels = 0;
@@ -0,0 +1,290 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <TimeStretcher.hpp>
+
+#include <QByteArray>
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+constexpr int g_decimation = 4;
+
+static inline float dotProduct(const float *a, const float *b, int n)
+{
+    // Independent partial sums allow the compiler to vectorize this loop
+    float sums[8] = {};
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        for (int j = 0; j < 8; ++j)
+            sums[j] += a[i + j] * b[i + j];
+    }
+    float sum = 0.0f;
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    for (float s : sums)
+        sum += s;
+    return sum;
+}
+static inline bool isBetterScore(double corr, double energy, double bestCorr, double bestEnergy)
+{
+    // Compares "corr / sqrt(energy)" without computing square roots
+    return (corr * abs(corr) * bestEnergy) > (bestCorr * abs(bestCorr) * energy);
+}
+
+TimeStretcher::TimeStretcher(int samplerate, int channels)
+    : m_samplerate(samplerate)
+    , m_channels(channels)
+    , m_overlapLen(max(samplerate / 50 / g_decimation, 4) * g_decimation) // ~20 ms
+    , m_searchLen(max(samplerate / 80 / g_decimation, 1) * g_decimation) // ~12.5 ms
+    , m_input(channels)
+    , m_inputPtrs(channels)
+    , m_overlap(channels, vector<float>(m_overlapLen))
+    , m_window(m_overlapLen)
+    , m_mono(2 * m_searchLen + m_overlapLen)
+    , m_monoRef(m_overlapLen)
+    , m_monoDec(m_mono.size() / g_decimation)
+    , m_monoRefDec(m_overlapLen / g_decimation)
+{
+    // Rising half of the Hann window, the falling half is "1 - m_window[i]"
+    for (int i = 0; i < m_overlapLen; ++i)
+        m_window[i] = 0.5 - 0.5 * cos(M_PI * i / m_overlapLen);
+}
+TimeStretcher::~TimeStretcher()
+{
+}
+
+void TimeStretcher::setSpeed(double speed)
+{
+    m_speed = speed;
+}
+
+float **TimeStretcher::inputBuffers(int count)
+{
+    const size_t required = m_inputSize + count;
+    for (int c = 0; c < m_channels; ++c)
+    {
+        auto &input = m_input[c];
+        if (input.size() < required)
+            input.resize(max(required, input.size() * 2));
+        m_inputPtrs[c] = input.data() + m_inputSize;
+    }
+    return m_inputPtrs.data();
+}
+void TimeStretcher::commit(int count)
+{
+    m_inputSize += count;
+}
+
+int TimeStretcher::process(QByteArray &dst, bool flush)
+{
+    const int inputEnd = m_inputSize;
+    if (flush)
+    {
+        // Pad with silence, so the remaining input can be consumed
+        const int padding = 2 * (m_overlapLen + m_searchLen);
+        float **buffers = inputBuffers(padding);
+        for (int c = 0; c < m_channels; ++c)
+            memset(buffers[c], 0, padding * sizeof(float));
+        commit(padding);
+    }
+
+    const double hop = m_overlapLen * m_speed;
+
+    int frames = 0;
+    for (double pos = m_nominalPos; canProcess(pos) && (!flush || pos < inputEnd); pos += hop)
+        ++frames;
+
+    if (frames == 0)
+    {
+        dst.clear();
+        if (flush)
+            reset();
+        else
+            discardInput();
+        return 0;
+    }
+
+    const int outSamples = frames * m_overlapLen;
+    dst.resize(outSamples * m_channels * sizeof(float));
+    auto dstF = reinterpret_cast<float *>(dst.data());
+
+    for (int f = 0; f < frames; ++f)
+    {
+        const int nominal = m_nominalPos;
+        const int best = m_hasPrev ? findBestOffset(nominal) : nominal;
+
+        float *out = dstF + f * m_overlapLen * m_channels;
+        for (int c = 0; c < m_channels; ++c)
+        {
+            const float *in = m_input[c].data() + best;
+            float *overlap = m_overlap[c].data();
+            if (m_hasPrev)
+            {
+                for (int i = 0; i < m_overlapLen; ++i)
+                    out[i * m_channels + c] = overlap[i] + m_window[i] * in[i];
+            }
+            else
+            {
+                for (int i = 0; i < m_overlapLen; ++i)
+                    out[i * m_channels + c] = in[i];
+            }
+            for (int i = 0; i < m_overlapLen; ++i)
+                overlap[i] = (1.0f - m_window[i]) * in[m_overlapLen + i];
+        }
+
+        m_prevPos = best;
+        m_hasPrev = true;
+        m_nominalPos += hop;
+    }
+
+    if (flush)
+        reset();
+    else
+        discardInput();
+
+    return outSamples;
+}
+void TimeStretcher::reset()
+{
+    m_inputSize = 0;
+    m_nominalPos = 0.0;
+    m_prevPos = 0;
+    m_hasPrev = false;
+}
+
+double TimeStretcher::getDelay() const
+{
+    return max(m_inputSize - m_nominalPos, 0.0) / m_speed / m_samplerate;
+}
+bool TimeStretcher::hasBufferedSamples() const
+{
+    return m_inputSize > static_cast<int>(m_nominalPos);
+}
+
+bool TimeStretcher::canProcess(double pos) const
+{
+    const int frameEnd = static_cast<int>(pos) + (m_hasPrev ? m_searchLen : 0) + 2 * m_overlapLen;
+    return frameEnd <= m_inputSize;
+}
+
+int TimeStretcher::findBestOffset(int nominal)
+{
+    // Searches around the nominal position for the segment which is the most
+    // similar to the natural continuation of the previous segment. The search
+    // is done on mono signal, at first decimated and then refined.
+
+    const int lo = max(nominal - m_searchLen, 0);
+    const int hi = nominal + m_searchLen;
+    const int ref = m_prevPos + m_overlapLen;
+    const int monoLen = hi - lo + m_overlapLen;
+
+    memset(m_mono.data(), 0, monoLen * sizeof(float));
+    memset(m_monoRef.data(), 0, m_overlapLen * sizeof(float));
+    for (int c = 0; c < m_channels; ++c)
+    {
+        const float *in = m_input[c].data();
+        for (int i = 0; i < monoLen; ++i)
+            m_mono[i] += in[lo + i];
+        for (int i = 0; i < m_overlapLen; ++i)
+            m_monoRef[i] += in[ref + i];
+    }
+
+    const int decLen = monoLen / g_decimation;
+    const int decRefLen = m_overlapLen / g_decimation;
+    for (int i = 0; i < decLen; ++i)
+    {
+        const float *m = m_mono.data() + i * g_decimation;
+        m_monoDec[i] = m[0] + m[1] + m[2] + m[3];
+    }
+    for (int i = 0; i < decRefLen; ++i)
+    {
+        const float *m = m_monoRef.data() + i * g_decimation;
+        m_monoRefDec[i] = m[0] + m[1] + m[2] + m[3];
+    }
+
+    const int decLags = decLen - decRefLen + 1;
+
+    double energy = dotProduct(m_monoDec.data(), m_monoDec.data(), decRefLen);
+    double bestCorr = 0.0, bestEnergy = 1.0;
+    int bestLag = (nominal - lo) / g_decimation;
+    for (int lag = 0; lag < decLags; ++lag)
+    {
+        if (lag > 0)
+        {
+            const float removed = m_monoDec[lag - 1];
+            const float added = m_monoDec[lag + decRefLen - 1];
+            energy = max(energy - removed * removed + added * added, 0.0);
+        }
+        if (energy <= 0.0)
+            continue;
+        const double corr = dotProduct(m_monoDec.data() + lag, m_monoRefDec.data(), decRefLen);
+        if (isBetterScore(corr, energy, bestCorr, bestEnergy))
+        {
+            bestCorr = corr;
+            bestEnergy = energy;
+            bestLag = lag;
+        }
+    }
+
+    const int coarse = bestLag * g_decimation;
+    const int fineFrom = max(coarse - g_decimation + 1, 0);
+    const int fineTo = min(coarse + g_decimation - 1, hi - lo);
+
+    int best = coarse;
+    bestCorr = 0.0;
+    bestEnergy = 1.0;
+    for (int lag = fineFrom; lag <= fineTo; ++lag)
+    {
+        const float *m = m_mono.data() + lag;
+        const double energy = dotProduct(m, m, m_overlapLen);
+        if (energy <= 0.0)
+            continue;
+        const double corr = dotProduct(m, m_monoRef.data(), m_overlapLen);
+        if (isBetterScore(corr, energy, bestCorr, bestEnergy))
+        {
+            bestCorr = corr;
+            bestEnergy = energy;
+            best = lag;
+        }
+    }
+
+    return lo + best;
+}
+
+void TimeStretcher::discardInput()
+{
+    int discard = static_cast<int>(m_nominalPos) - m_searchLen;
+    if (m_hasPrev)
+        discard = min(discard, m_prevPos + m_overlapLen);
+    discard = min(discard, m_inputSize);
+    if (discard <= 0)
+        return;
+
+    const int remaining = m_inputSize - discard;
+    for (int c = 0; c < m_channels; ++c)
+        memmove(m_input[c].data(), m_input[c].data() + discard, remaining * sizeof(float));
+
+    m_inputSize = remaining;
+    m_nominalPos -= discard;
+    m_prevPos -= discard;
+}
@@ -0,0 +1,75 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+class QByteArray;
+
+/*
+ * WSOLA (Waveform Similarity Overlap-Add) time-stretcher, it changes the tempo
+ * without changing the pitch. All buffers are kept between calls, so nothing is
+ * allocated once they reach their working size.
+ */
+class TimeStretcher
+{
+public:
+    TimeStretcher(int samplerate, int channels);
+    ~TimeStretcher();
+
+    void setSpeed(double speed);
+
+    // Planar buffers for "count" new samples, call "commit()" with the number of written samples
+    float **inputBuffers(int count);
+    void commit(int count);
+
+    // Produces interleaved output, returns the number of output samples
+    int process(QByteArray &dst, bool flush);
+    void reset();
+
+    double getDelay() const;
+    bool hasBufferedSamples() const;
+
+private:
+    bool canProcess(double pos) const;
+    int findBestOffset(int nominal);
+    void discardInput();
+
+private:
+    const int m_samplerate;
+    const int m_channels;
+    const int m_overlapLen;
+    const int m_searchLen;
+
+    double m_speed = 1.0;
+
+    std::vector<std::vector<float>> m_input;
+    std::vector<float *> m_inputPtrs;
+    int m_inputSize = 0;
+
+    std::vector<std::vector<float>> m_overlap;
+    std::vector<float> m_window;
+
+    std::vector<float> m_mono, m_monoRef;
+    std::vector<float> m_monoDec, m_monoRefDec;
+
+    double m_nominalPos = 0.0;
+    int m_prevPos = 0;
+    bool m_hasPrev = false;
+};
@@ -78,6 +78,61 @@ bool VideoFilter::removeLastFromInternalBuffer()
     return false;
 }
 
+void VideoFilter::addGenericCPUPixelFormats()
+{
+    // Formats which can be processed by CPU filters which work on each plane
+    // separately and depend only on the sample width and number of planes.
+    m_supportedPixelFormats += {
+        AV_PIX_FMT_GRAY8,
+        AV_PIX_FMT_GRAY9,
+        AV_PIX_FMT_GRAY10,
+        AV_PIX_FMT_GRAY12,
+        AV_PIX_FMT_GRAY16,
+
+        AV_PIX_FMT_NV12,
+        AV_PIX_FMT_NV21,
+        AV_PIX_FMT_NV16,
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(56, 31, 100)
+        AV_PIX_FMT_NV24,
+        AV_PIX_FMT_NV42,
+#endif
+        AV_PIX_FMT_NV20,
+        AV_PIX_FMT_P010,
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(58, 2, 100)
+        AV_PIX_FMT_P012,
+#endif
+        AV_PIX_FMT_P016,
+
+        AV_PIX_FMT_YUV420P9,
+        AV_PIX_FMT_YUV420P10,
+        AV_PIX_FMT_YUV420P12,
+        AV_PIX_FMT_YUV420P14,
+        AV_PIX_FMT_YUV420P16,
+
+        AV_PIX_FMT_YUV422P9,
+        AV_PIX_FMT_YUV422P10,
+        AV_PIX_FMT_YUV422P12,
+        AV_PIX_FMT_YUV422P14,
+        AV_PIX_FMT_YUV422P16,
+
+        AV_PIX_FMT_YUV444P9,
+        AV_PIX_FMT_YUV444P10,
+        AV_PIX_FMT_YUV444P12,
+        AV_PIX_FMT_YUV444P14,
+        AV_PIX_FMT_YUV444P16,
+
+        AV_PIX_FMT_YUV440P10,
+        AV_PIX_FMT_YUV440P12,
+
+        AV_PIX_FMT_GBRP,
+        AV_PIX_FMT_GBRP9,
+        AV_PIX_FMT_GBRP10,
+        AV_PIX_FMT_GBRP12,
+        AV_PIX_FMT_GBRP14,
+        AV_PIX_FMT_GBRP16,
+    };
+}
+
 void VideoFilter::processParamsDeint()
 {
     m_secondFrame = false;
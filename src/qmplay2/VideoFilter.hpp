@@ -63,7 +63,14 @@ public:
 
     virtual bool filter(QQueue<Frame> &framesQueue) = 0;
 
+    inline AVPixelFormats supportedPixelFormats() const
+    {
+        return m_supportedPixelFormats;
+    }
+
 protected:
+    void addGenericCPUPixelFormats();
+
     void processParamsDeint();
 
     void addFramesToInternalQueue(QQueue<Frame> &framesQueue);
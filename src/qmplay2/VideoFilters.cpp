@@ -21,6 +21,8 @@
 #include <Frame.hpp>
 #include <Module.hpp>
 
+#include <algorithm>
+
 class VideoFiltersThr final : public QThread
 {
 public:
@@ -136,6 +138,19 @@ void VideoFilters::averageTwoLines(quint8 *__restrict__ dest, const quint8 *__re
     for (int i = 0; i < linesize; ++i)
         dest[i] = (src1[i] + src2[i] + 1) >> 1; // This generates "pavgb" instruction on x86
 }
+void VideoFilters::averageTwoLines16(quint8 *__restrict__ dest, const quint8 *__restrict__ src1, const quint8 *__restrict__ src2, int linesize)
+{
+    auto dest16 = reinterpret_cast<quint16 *__restrict__>(dest);
+    auto src16a = reinterpret_cast<const quint16 *__restrict__>(src1);
+    auto src16b = reinterpret_cast<const quint16 *__restrict__>(src2);
+    const int count = linesize / sizeof(quint16);
+    for (int i = 0; i < count; ++i)
+        dest16[i] = (src16a[i] + src16b[i] + 1) >> 1; // This generates "pavgw" instruction on x86
+}
+VideoFilters::AverageTwoLinesFn VideoFilters::averageTwoLinesFn(const Frame &frame)
+{
+    return (frame.depth() > 8) ? averageTwoLines16 : averageTwoLines;
+}
 
 VideoFilters::VideoFilters() :
     filtersThr(*(new VideoFiltersThr(*this))),
@@ -253,3 +268,20 @@ bool VideoFilters::readyRead()
     filtersThr.bufferMutex.unlock();
     return ret;
 }
+
+AVPixelFormats VideoFilters::supportedPixelFormats(const AVPixelFormats &pixelFormats) const
+{
+    AVPixelFormats ret;
+    for (const AVPixelFormat pixFmt : pixelFormats)
+    {
+        const bool supported = std::all_of(filters.cbegin(), filters.cend(), [=](const std::shared_ptr<VideoFilter> &filter) {
+            const auto filterPixelFormats = filter->supportedPixelFormats();
+            return filterPixelFormats.isEmpty() || filterPixelFormats.contains(pixFmt);
+        });
+        if (supported)
+            ret += pixFmt;
+    }
+    if (ret.isEmpty())
+        return pixelFormats;
+    return ret;
+}
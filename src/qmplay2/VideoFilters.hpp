@@ -36,6 +36,10 @@ class QMPLAY2SHAREDLIB_EXPORT VideoFilters
     friend class VideoFiltersThr;
 public:
     static void averageTwoLines(quint8 *dest, const quint8 *src1, const quint8 *src2, int linesize);
+    static void averageTwoLines16(quint8 *dest, const quint8 *src1, const quint8 *src2, int linesize);
+
+    using AverageTwoLinesFn = void (*)(quint8 *dest, const quint8 *src1, const quint8 *src2, int linesize);
+    static AverageTwoLinesFn averageTwoLinesFn(const Frame &frame);
 
     VideoFilters();
     ~VideoFilters();
@@ -54,6 +58,8 @@ public:
     bool getFrame(Frame &videoFrame);
 
     bool readyRead();
+
+    AVPixelFormats supportedPixelFormats(const AVPixelFormats &pixelFormats) const;
 private:
     QQueue<Frame> outputQueue;
     QVector<std::shared_ptr<VideoFilter>> filters;
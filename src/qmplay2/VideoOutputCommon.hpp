@@ -30,7 +30,7 @@ class QMouseEvent;
 class QVariant;
 class QWidget;
 
-class VideoOutputCommon : public X11BypassCompositor
+class QMPLAY2SHAREDLIB_EXPORT VideoOutputCommon : public X11BypassCompositor
 {
 protected:
     VideoOutputCommon(bool yInverted);
@@ -51,6 +51,30 @@
 #ifndef GL_PIXEL_UNPACK_BUFFER
     #define GL_PIXEL_UNPACK_BUFFER 0x88EC
 #endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+    #define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+    #define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+    #define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+    #define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+    #define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_WAIT_FAILED
+    #define GL_WAIT_FAILED 0x911D
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+    #define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
 #ifndef GL_TEXTURE_RECTANGLE_ARB
     #define GL_TEXTURE_RECTANGLE_ARB 0x84F5
 #endif
@@ -61,6 +85,8 @@
     #define GL_RED GL_RED_EXT
 #endif
 
+constexpr quint64 g_pboFenceTimeout = 100 * 1000 * 1000; // 100 ms
+
 OpenGLCommon::OpenGLCommon() :
     VideoOutputCommon(false),
     vSync(true),
@@ -252,6 +278,15 @@ void OpenGLCommon::initializeGL()
     }
 #endif
 
+    m_glBufferStorage = nullptr;
+    if (hasPbo && m_glInstance->hasBufferStorage && m_glInstance->hasSync && m_glInstance->hasMapBufferRange)
+    {
+        using BufferStorageFn = decltype(m_glBufferStorage);
+        m_glBufferStorage = reinterpret_cast<BufferStorageFn>(QOpenGLContext::currentContext()->getProcAddress(
+            m_glInstance->isGLES ? "glBufferStorageEXT" : "glBufferStorage"
+        ));
+    }
+
     shaderProgramVideo.reset(new QOpenGLShaderProgram);
     shaderProgramOSD.reset(new QOpenGLShaderProgram);
 
@@ -342,7 +377,7 @@ void OpenGLCommon::initializeGL()
 
     if (hasPbo)
     {
-        glGenBuffers(1 + texturesToGen, pbo);
+        glGenBuffers(1, &osdPbo);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     }
 
@@ -410,20 +445,19 @@ void OpenGLCommon::paintGL()
                 );
 
                 /* Prepare textures */
+                GLsizeiptr pboSizes[3] = {};
                 for (qint32 p = 0; p < 3; ++p)
                 {
                     const GLsizei w = correctLinesize ? videoFrame.linesize(p) / bytesMultiplier : widths[p];
                     const GLsizei h = heights[p];
                     if (p == 0)
                         m_textureSize = QSize(w, h);
-                    if (hasPbo)
-                    {
-                        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[p + 1]);
-                        glBufferData(GL_PIXEL_UNPACK_BUFFER, w * h * bytesMultiplier, nullptr, GL_DYNAMIC_DRAW);
-                    }
+                    pboSizes[p] = w * h * bytesMultiplier;
                     glBindTexture(GL_TEXTURE_2D, textures[p + 1]);
                     glTexImage2D(GL_TEXTURE_2D, 0, internalFmt, w, h, 0, fmt, dataType, nullptr);
                 }
+                if (hasPbo)
+                    createPboRing(pboSizes);
 
                 /* Prepare texture coordinates */
                 texCoordYCbCr[2] = texCoordYCbCr[6] = (videoFrame.linesize(0) / bytesMultiplier == widths[0]) ? 1.0f : (widths[0] / (videoFrame.linesize(0) / bytesMultiplier + 1.0f));
@@ -457,21 +491,16 @@ void OpenGLCommon::paintGL()
         else
         {
             /* Load textures */
+            PboSlot *pboSlot = hasPbo ? &acquirePboSlot() : nullptr;
             for (qint32 p = 0; p < 3; ++p)
             {
                 const quint8 *data = videoFrame.constData(p);
                 const GLsizei w = correctLinesize ? videoFrame.linesize(p) / bytesMultiplier : widths[p];
                 const GLsizei h = heights[p];
-                if (hasPbo)
+                if (pboSlot)
                 {
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[p + 1]);
-                    quint8 *dst = nullptr;
-                    if (m_glInstance->hasMapBufferRange)
-                        dst = (quint8 *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, w * h * bytesMultiplier, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
-#if !defined(QT_OPENGL_ES_2) && !defined(QT_FEATURE_opengles2)
-                    else
-                        dst = (quint8 *)m_gl15.glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
-#endif
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pboSlot->buffers[p]);
+                    quint8 *dst = mapPbo(*pboSlot, p, w * h * bytesMultiplier);
                     if (!dst)
                         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
                     else
@@ -484,22 +513,35 @@ void OpenGLCommon::paintGL()
                             data += videoFrame.linesize(p);
                             dst  += w * bytesMultiplier;
                         }
-                        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                        if (!m_persistentPbo)
+                            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
                         data = nullptr;
                     }
                 }
                 glActiveTexture(GL_TEXTURE0 + p);
                 glBindTexture(GL_TEXTURE_2D, textures[p + 1]);
-                if (hasPbo || correctLinesize)
+                if (!data || correctLinesize) // Uploading from PBO or without padding
+                {
                     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, fmt, dataType, data);
+                }
+                else if (m_glInstance->hasUnpackRowLength)
+                {
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, videoFrame.linesize(p) / bytesMultiplier);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, fmt, dataType, data);
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                }
                 else for (int y = 0; y < h; ++y)
                 {
                     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, w, 1, fmt, dataType, data);
                     data += videoFrame.linesize(p);
                 }
             }
-            if (hasPbo)
+            if (pboSlot)
+            {
                 glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                if (m_glInstance->hasSync)
+                    pboSlot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
         }
 
         if (!m_hwInterop || m_hwInterop->isCopy())
@@ -633,7 +675,7 @@ void OpenGLCommon::paintGL()
             if (hasPbo)
             {
                 const GLsizeiptr dataSize = (osdImg.width() * osdImg.height()) << 2;
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[0]);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, osdPbo);
                 if (hasNewSize)
                     glBufferData(GL_PIXEL_UNPACK_BUFFER, dataSize, nullptr, GL_DYNAMIC_DRAW);
                 quint8 *dst = nullptr;
@@ -695,10 +737,99 @@ void OpenGLCommon::contextAboutToBeDestroyed()
     deleteSphereVbo();
     const int texturesToDel = m_hwInterop ? 0 : numPlanes;
     if (hasPbo)
-        glDeleteBuffers(1 + texturesToDel, pbo);
+    {
+        deletePboRing();
+        glDeleteBuffers(1, &osdPbo);
+        osdPbo = 0;
+    }
     glDeleteTextures(texturesToDel + 1, textures);
 }
 
+void OpenGLCommon::createPboRing(const GLsizeiptr sizes[3])
+{
+    deletePboRing();
+
+    m_persistentPbo = (m_glBufferStorage != nullptr);
+    for (PboSlot &slot : m_pboRing)
+    {
+        glGenBuffers(3, slot.buffers);
+        for (int p = 0; p < 3; ++p)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffers[p]);
+            if (m_persistentPbo)
+            {
+                constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                m_glBufferStorage(GL_PIXEL_UNPACK_BUFFER, sizes[p], nullptr, flags);
+                slot.mapped[p] = (quint8 *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, sizes[p], flags);
+                if (!slot.mapped[p])
+                {
+                    // Fall back to mapping on every frame
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    m_glBufferStorage = nullptr;
+                    createPboRing(sizes);
+                    return;
+                }
+            }
+            else
+            {
+                glBufferData(GL_PIXEL_UNPACK_BUFFER, sizes[p], nullptr, GL_STREAM_DRAW);
+            }
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+void OpenGLCommon::deletePboRing()
+{
+    for (PboSlot &slot : m_pboRing)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        glDeleteBuffers(3, slot.buffers); // Also unmaps persistently mapped buffers
+        slot = PboSlot();
+    }
+    m_pboRingIdx = 0;
+    m_persistentPbo = false;
+}
+OpenGLCommon::PboSlot &OpenGLCommon::acquirePboSlot()
+{
+    PboSlot &slot = m_pboRing[m_pboRingIdx];
+    m_pboRingIdx = (m_pboRingIdx + 1) % m_pboRing.size();
+    if (slot.fence)
+    {
+        // The slot was used two frames ago, so the fence is usually already signaled
+        const GLenum ret = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_pboFenceTimeout);
+        slot.idle = (ret != GL_TIMEOUT_EXPIRED && ret != GL_WAIT_FAILED);
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    else
+    {
+        // Without fences nothing is known about the buffer
+        slot.idle = m_glInstance->hasSync;
+    }
+    return slot;
+}
+quint8 *OpenGLCommon::mapPbo(const PboSlot &slot, int p, GLsizeiptr size)
+{
+    if (m_persistentPbo)
+    {
+        if (slot.idle)
+            return slot.mapped[p];
+        return nullptr; // GPU might still read from it, upload directly from frame
+    }
+    if (m_glInstance->hasMapBufferRange)
+    {
+        // Nothing reads from an idle buffer, so there is no need for the implicit synchronization
+        const GLbitfield access = slot.idle ? GL_MAP_UNSYNCHRONIZED_BIT : GL_MAP_INVALIDATE_BUFFER_BIT;
+        return (quint8 *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | access);
+    }
+#if !defined(QT_OPENGL_ES_2) && !defined(QT_FEATURE_opengles2)
+    return (quint8 *)m_gl15.glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+#else
+    return nullptr;
+#endif
+}
+
 void OpenGLCommon::dispatchEvent(QEvent *e, QObject *p)
 {
     if (e->type() == QEvent::Resize)
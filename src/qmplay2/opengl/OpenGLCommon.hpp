@@ -35,6 +35,8 @@
 #include <QImage>
 #include <QTimer>
 
+#include <array>
+
 class OpenGLHWInterop;
 
 class OpenGLCommon : public VideoOutputCommon, public QOpenGLExtraFunctions
@@ -100,6 +102,18 @@ private:
     inline void resetSphereVbo();
     inline void deleteSphereVbo();
     void loadSphere();
+
+    struct PboSlot
+    {
+        quint32 buffers[3] = {};
+        quint8 *mapped[3] = {}; // Persistently mapped memory
+        GLsync fence = nullptr;
+        bool idle = false; // GPU finished reading from buffers
+    };
+    void createPboRing(const GLsizeiptr sizes[3]);
+    void deletePboRing();
+    PboSlot &acquirePboSlot();
+    quint8 *mapPbo(const PboSlot &slot, int p, GLsizeiptr size);
 public:
     const std::shared_ptr<OpenGLInstance> m_glInstance;
     std::shared_ptr<OpenGLHWInterop> m_hwInterop;
@@ -126,7 +140,11 @@ public:
 
     bool m_canUse16bitTexture = false;
 
-    quint32 pbo[4];
+    quint32 osdPbo = 0;
+    std::array<PboSlot, 3> m_pboRing; // Frame N is uploaded while the GPU may still read frames N-1 and N-2
+    int m_pboRingIdx = 0;
+    bool m_persistentPbo = false;
+    void (QOPENGLF_APIENTRYP m_glBufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags) = nullptr;
     bool hasPbo;
 
     bool isPaused, isOK, hasImage, doReset, setMatrix, correctLinesize, m_gl3;
@@ -50,6 +50,20 @@ bool OpenGLInstance::init()
         hasPbo = (hasMapBuffer || hasMapBufferRange) && (majorVersion >= (isGLES ? 3 : 2) || extensions.contains("GL_ARB_pixel_buffer_object"));
     }
 
+    const int version = majorVersion * 10 + context.format().minorVersion();
+    if (isGLES)
+    {
+        hasSync = (majorVersion >= 3);
+        hasBufferStorage = extensions.contains("GL_EXT_buffer_storage");
+        hasUnpackRowLength = (majorVersion >= 3 || extensions.contains("GL_EXT_unpack_subimage"));
+    }
+    else
+    {
+        hasSync = (version >= 32 || extensions.contains("GL_ARB_sync"));
+        hasBufferStorage = (version >= 44 || extensions.contains("GL_ARB_buffer_storage"));
+        hasUnpackRowLength = true;
+    }
+
 #ifndef Q_OS_MACOS // On macOS I have always OpenGL 2.1...
     glVer = majorVersion * 10 + context.format().minorVersion();
 #endif
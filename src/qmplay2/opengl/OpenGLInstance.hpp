@@ -40,6 +40,10 @@ public:
     bool hasMapBuffer = false;
     bool hasMapBufferRange = false;
 
+    bool hasSync = false;
+    bool hasBufferStorage = false;
+    bool hasUnpackRowLength = false;
+
     bool canUse16bitTexture = false;
 
     int glVer = 0;
@@ -0,0 +1,233 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../../qmvk/Device.hpp"
+#include "../../qmvk/Queue.hpp"
+#include "../../qmvk/CommandBuffer.hpp"
+#include "../../qmvk/ShaderModule.hpp"
+#include "../../qmvk/Sampler.hpp"
+#include "../../qmvk/Image.hpp"
+
+#include "VulkanComputeFilter.hpp"
+#include "VulkanInstance.hpp"
+#include "VulkanImagePool.hpp"
+
+namespace QmVk {
+
+ComputeFilter::ComputeFilter(const shared_ptr<HWInterop> &hwInterop, const char *shaderName, uint32_t pushConstantsSize)
+    : VideoFilter(true)
+    , m_instance(m_vkImagePool->instance())
+    , m_shaderName(shaderName)
+    , m_pushConstantsSize(pushConstantsSize)
+{
+    m_supportedPixelFormats += {
+            AV_PIX_FMT_NV12,
+            AV_PIX_FMT_P010,
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(58, 2, 100)
+            AV_PIX_FMT_P012,
+#endif
+            AV_PIX_FMT_P016,
+            AV_PIX_FMT_NV16,
+            AV_PIX_FMT_NV20,
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(56, 31, 100)
+            AV_PIX_FMT_NV24,
+#endif
+    };
+    if (m_instance->hasStorage16bit() && m_instance->supportedPixelFormats().contains(AV_PIX_FMT_YUV420P10))
+    {
+        m_supportedPixelFormats += {
+            AV_PIX_FMT_YUV420P9,
+            AV_PIX_FMT_YUV420P10,
+            AV_PIX_FMT_YUV420P12,
+            AV_PIX_FMT_YUV420P14,
+            AV_PIX_FMT_YUV420P16,
+
+            AV_PIX_FMT_YUV422P9,
+            AV_PIX_FMT_YUV422P10,
+            AV_PIX_FMT_YUV422P12,
+            AV_PIX_FMT_YUV422P14,
+            AV_PIX_FMT_YUV422P16,
+
+            AV_PIX_FMT_YUV444P9,
+            AV_PIX_FMT_YUV444P10,
+            AV_PIX_FMT_YUV444P12,
+            AV_PIX_FMT_YUV444P14,
+            AV_PIX_FMT_YUV444P16,
+        };
+    }
+
+    m_vkHwInterop = hwInterop;
+}
+ComputeFilter::~ComputeFilter()
+{
+}
+
+bool ComputeFilter::ensureResources()
+{
+    auto device = m_instance->device();
+    if (device && m.device == device)
+        return true;
+
+    if (m.device)
+        m = {};
+
+    m.device = move(device);
+    if (!m.device)
+        return false;
+
+    const auto shaderCode = Instance::readShader(m_shaderName);
+    if (shaderCode.empty())
+    {
+        m = {};
+        return false;
+    }
+
+    try
+    {
+        m.sampler = Sampler::create(m.device);
+
+        auto shaderModule = ShaderModule::create(
+            m.device,
+            vk::ShaderStageFlagBits::eCompute,
+            shaderCode
+        );
+
+        const int nf = (m_deintFlags & DoubleFramerate) ? 2 : 1;
+
+        for (auto &&computeF : m.computes)
+        {
+            for (int f = 0; f < nf; ++f)
+            {
+                auto &&compute = computeF[f];
+
+                compute = ComputePipeline::create(
+                    m.device,
+                    shaderModule,
+                    m_pushConstantsSize
+                );
+
+                compute->setLocalWorkgroupSize(vk::Extent2D(64, 1));
+            }
+        }
+
+        m.commandBuffer = CommandBuffer::create(getVulkanComputeQueue(m.device));
+        if (m.commandBuffer->queue()->queueFamilyIndex() != m.device->queueFamilyIndex(0))
+            m.filtersOnOtherQueueFamiliy = m_instance->setFiltersOnOtherQueueFamiliy();
+    }
+    catch (const vk::SystemError &e)
+    {
+        handleError(e);
+        return false;
+    }
+
+    return true;
+}
+void ComputeFilter::handleError(const vk::SystemError &e)
+{
+    if (e.code() == vk::Result::eErrorDeviceLost)
+        m_instance->resetDevice(m.device);
+    else
+        m_error = true;
+    m_syncData.reset();
+    m_syncFrames.clear();
+    m = {};
+}
+
+vector<shared_ptr<Image>> ComputeFilter::beginCommands(const vector<Frame *> &frames)
+{
+    vector<shared_ptr<Image>> images;
+    vector<CopyImageLinearToOptimalFn> copyFns(frames.size());
+
+    images.reserve(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        auto image = vulkanImageFromFrame(*frames[i], m.device, &copyFns[i]);
+        if (!image)
+            return {};
+        images.push_back(move(image));
+    }
+
+    m_submitInfo = vk::SubmitInfo();
+    if (m_vkHwInterop)
+    {
+        m_syncFrames.clear();
+        for (auto &&frame : frames)
+            m_syncFrames.push_back(*frame);
+        m_syncData = m_vkHwInterop->sync(m_syncFrames, &m_submitInfo);
+    }
+
+    m.commandBuffer->resetAndBegin();
+    for (auto &&copyFn : copyFns)
+    {
+        if (copyFn)
+            copyFn(m.commandBuffer);
+    }
+
+    return images;
+}
+
+Frame ComputeFilter::takeDestFrame(const Frame &srcFrame, shared_ptr<Image> &destImage)
+{
+    auto destFrame = m_vkImagePool->takeOptimalToFrame(
+        srcFrame,
+        Frame::convert2PlaneTo3Plane(srcFrame.pixelFormat())
+    );
+    if (destFrame.isEmpty())
+        return destFrame;
+
+    destFrame.setNoInterlaced();
+    destImage = vulkanImageFromFrame(destFrame);
+    return destFrame;
+}
+
+void ComputeFilter::dispatch(
+    uint32_t p,
+    uint32_t f,
+    uint32_t srcNumPlanes,
+    uint32_t filterSpecializationData,
+    const MemoryObjectDescrs &memoryObjects,
+    const shared_ptr<Image> &destImage)
+{
+    auto &&compute = m.computes[p][f];
+
+    compute->setCustomSpecializationData({
+        filterSpecializationData,
+        srcNumPlanes,
+        (srcNumPlanes == 3) ? p  : ((p != 0) ? 1u : 0u),
+        (srcNumPlanes == 3) ? 0u : ((p == 2) ? 1u : 0u),
+        p
+    });
+    compute->setMemoryObjects(memoryObjects);
+    compute->prepare();
+
+    compute->recordCommands(
+        m.commandBuffer,
+        compute->groupCount(destImage->size(p))
+    );
+}
+
+void ComputeFilter::endSubmitAndWait()
+{
+    if (m_vkHwInterop)
+        m_vkHwInterop->updateInfo(m_syncFrames);
+    m.commandBuffer->endSubmitAndWait(move(m_submitInfo));
+    m_syncData.reset();
+    m_syncFrames.clear();
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMPlay2Lib.hpp>
+
+#include <VideoFilter.hpp>
+
+#include "../../qmvk/ComputePipeline.hpp"
+
+#include "VulkanHWInterop.hpp"
+
+namespace QmVk {
+
+using namespace std;
+
+class Instance;
+class Sampler;
+
+/*
+ * Common part of video filters implemented as Vulkan compute shaders.
+ *
+ * The shader is dispatched once per destination plane and gets the source plane
+ * layout through the specialization constants (after the local workgroup size):
+ * 3 - filter specific value, 4 - source plane count, 5 - source plane,
+ * 6 - source color component, 7 - destination plane.
+ */
+class QMPLAY2SHAREDLIB_EXPORT ComputeFilter : public VideoFilter
+{
+protected:
+    ComputeFilter(const shared_ptr<HWInterop> &hwInterop, const char *shaderName, uint32_t pushConstantsSize);
+    ~ComputeFilter();
+
+    bool ensureResources();
+    void handleError(const vk::SystemError &e);
+
+    // Imports frames as Vulkan images, synchronizes them and starts recording commands
+    vector<shared_ptr<Image>> beginCommands(const vector<Frame *> &frames);
+
+    Frame takeDestFrame(const Frame &srcFrame, shared_ptr<Image> &destImage);
+
+    template<typename T>
+    inline T *pushConstants(uint32_t p, uint32_t f)
+    {
+        return m.computes[p][f]->pushConstants<T>();
+    }
+
+    void dispatch(
+        uint32_t p,
+        uint32_t f,
+        uint32_t srcNumPlanes,
+        uint32_t filterSpecializationData,
+        const MemoryObjectDescrs &memoryObjects,
+        const shared_ptr<Image> &destImage
+    );
+
+    void endSubmitAndWait();
+
+protected:
+    const shared_ptr<Instance> m_instance;
+
+    bool m_error = false;
+
+    struct
+    {
+        shared_ptr<Device> device;
+        shared_ptr<Sampler> sampler;
+        shared_ptr<ComputePipeline> computes[3][2];
+        shared_ptr<CommandBuffer> commandBuffer;
+        shared_ptr<function<void()>> filtersOnOtherQueueFamiliy;
+    } m;
+
+private:
+    const char *const m_shaderName;
+    const uint32_t m_pushConstantsSize;
+
+    vector<Frame> m_syncFrames;
+    vk::SubmitInfo m_submitInfo;
+    HWInterop::SyncDataPtr m_syncData;
+};
+
+}
@@ -141,6 +141,11 @@ static QFileInfo getPrimaryX11CardFile()
 
 constexpr auto s_queueFlags = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
 
+bool Instance::hasShader(const QString &fileName)
+{
+    return QResource(":/vulkan/" + fileName + ".spv").isValid();
+}
+
 vector<uint32_t> Instance::readShader(const QString &fileName)
 {
     const QResource res(":/vulkan/" + fileName + ".spv");
@@ -37,6 +37,7 @@ class ImagePool;
 class QMPLAY2SHAREDLIB_EXPORT Instance : public GPUInstance, public AbstractInstance
 {
 public: // Helpers
+    static bool hasShader(const QString &fileName);
     static vector<uint32_t> readShader(const QString &fileName);
 
     static vk::Format fromFFmpegPixelFormat(int avPixFmt);
@@ -0,0 +1,147 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../../qmvk/Image.hpp"
+
+#include "VulkanSimpleDeint.hpp"
+
+namespace QmVk {
+
+struct alignas(16) SimpleDeintPushConstants
+{
+    int keepParity;
+    int height;
+};
+
+bool SimpleDeint::getMethod(const QString &name, Method &method)
+{
+    if (name == "Blend")
+        method = Method::Blend;
+    else if (name == "Bob")
+        method = Method::Bob;
+    else if (name == "Discard")
+        method = Method::Discard;
+    else
+        return false;
+    return true;
+}
+
+SimpleDeint::SimpleDeint(const shared_ptr<HWInterop> &hwInterop, Method method)
+    : ComputeFilter(hwInterop, "deint.comp", sizeof(SimpleDeintPushConstants))
+    , m_method(method)
+{
+    addParam("DeinterlaceFlags");
+    addParam("W");
+    addParam("H");
+}
+SimpleDeint::~SimpleDeint()
+{
+}
+
+bool SimpleDeint::filter(QQueue<Frame> &framesQueue)
+{
+    if (m_error)
+        return false;
+
+    addFramesToDeinterlace(framesQueue);
+
+    if (!m_internalQueue.isEmpty()) try
+    {
+        if (!ensureResources())
+        {
+            clearBuffer();
+            return false;
+        }
+
+        Frame &srcFrame = m_internalQueue[0];
+
+        const auto images = beginCommands({&srcFrame});
+        if (images.empty())
+        {
+            clearBuffer();
+            return false;
+        }
+
+        const auto &srcImage = images[0];
+        const uint32_t srcNumPlanes = srcImage->numPlanes();
+        const bool tff = isTopFieldFirst(srcFrame);
+        const bool doubler = (m_method == Method::Bob);
+
+        for (uint32_t f = 0; f < 2; ++f)
+        {
+            shared_ptr<Image> destImage;
+            auto destFrame = takeDestFrame(srcFrame, destImage);
+            if (destFrame.isEmpty())
+            {
+                clearBuffer();
+                return false;
+            }
+
+            for (uint32_t p = 0; p < 3; ++p)
+            {
+                auto pushConstants = this->pushConstants<SimpleDeintPushConstants>(p, f);
+                pushConstants->keepParity = doubler
+                    ? (m_secondFrame == tff)
+                    : !tff
+                ;
+                pushConstants->height = destImage->size(p).height;
+
+                dispatch(p, f, srcNumPlanes, m_method == Method::Blend, {
+                    {srcImage, m.sampler},
+                    {destImage, MemoryObjectDescr::Access::Write},
+                }, destImage);
+            }
+
+            const bool lastIteration = (f == 1 || !doubler);
+
+            if (lastIteration)
+                endSubmitAndWait();
+
+            if (doubler)
+                deinterlaceDoublerCommon(destFrame);
+            else
+                m_internalQueue.removeFirst();
+
+            framesQueue.enqueue(destFrame);
+
+            if (lastIteration)
+                break;
+        }
+    }
+    catch (const vk::SystemError &e)
+    {
+        handleError(e);
+        clearBuffer();
+        return false;
+    }
+
+    return !m_internalQueue.isEmpty();
+}
+
+bool SimpleDeint::processParams(bool *paramsCorrected)
+{
+    Q_UNUSED(paramsCorrected)
+    processParamsDeint();
+    if (getParam("W").toInt() < 2 || getParam("H").toInt() < 4)
+        return false;
+    if ((m_method == Method::Bob) != bool(m_deintFlags & DoubleFramerate))
+        return false;
+    return true;
+}
+
+}
@@ -0,0 +1,50 @@
+/*
+    QMPlay2 is a video and audio player.
+    Copyright (C) 2010-2026  Błażej Szczygieł
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "VulkanComputeFilter.hpp"
+
+namespace QmVk {
+
+// Blend, Bob and Discard deinterlacing methods
+class QMPLAY2SHAREDLIB_EXPORT SimpleDeint : public ComputeFilter
+{
+public:
+    enum class Method
+    {
+        Blend,
+        Bob,
+        Discard,
+    };
+
+    static bool getMethod(const QString &name, Method &method);
+
+public:
+    SimpleDeint(const shared_ptr<HWInterop> &hwInterop, Method method);
+    ~SimpleDeint();
+
+    bool filter(QQueue<Frame> &framesQueue) override;
+
+    bool processParams(bool *paramsCorrected) override;
+
+private:
+    const Method m_method;
+};
+
+}